@@ -96,7 +96,7 @@ bool URuntimeArchiverGZip::OpenArchiveFromStorage(FString ArchivePath)
 		return false;
 	}
 
-	if (!TarArchiver->OpenArchiveFromMemory(TarArchiveData))
+	if (!TarArchiver->OpenArchiveFromMemory(MoveTemp(TarArchiveData)))
 	{
 		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open gzip archive from storage due to tar archiver error"));
 		Reset();
@@ -130,7 +130,7 @@ bool URuntimeArchiverGZip::OpenArchiveFromMemory(const TArray64<uint8>& ArchiveD
 		return false;
 	}
 
-	if (!TarArchiver->OpenArchiveFromMemory(TarArchiveData))
+	if (!TarArchiver->OpenArchiveFromMemory(MoveTemp(TarArchiveData)))
 	{
 		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open gzip archive from memory due to tar archiver error"));
 		Reset();
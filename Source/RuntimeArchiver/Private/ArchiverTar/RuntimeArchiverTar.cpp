@@ -5,731 +5,4340 @@
 #include "RuntimeArchiverTarOperations.h"
 #include "RuntimeArchiverUtilities.h"
 #include "ArchiverTar/RuntimeArchiverTarHeader.h"
+#include "ArchiverTar/RuntimeArchiverTarScanner.h"
+#include "Streams/RuntimeArchiverAsyncFileStream.h"
 #include "Streams/RuntimeArchiverFileStream.h"
+#include "Streams/RuntimeArchiverHashingStream.h"
+#include "Streams/RuntimeArchiverMappedFileStream.h"
 #include "Streams/RuntimeArchiverMemoryStream.h"
+#include "Streams/RuntimeArchiverSegmentedMemoryStream.h"
+#include "Streams/RuntimeArchiverVolumeStream.h"
 #include "Misc/Paths.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Hash/CityHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
+
+namespace
+{
+	/** Size of the buffer used to stream entry data between storage and the archive in chunks */
+	constexpr int64 StreamingChunkSize = 1024 * 1024;
+
+	/**
+	 * Hash the next part of the content. The content is hashed in chunks of StreamingChunkSize, so the result does not depend on whether it comes from memory or storage
+	 *
+	 * @param Hash Hash of the preceding content
+	 * @param Data Content data
+	 * @param Size Content size. Must be a multiple of StreamingChunkSize unless it is the last part of the content
+	 * @return Hash of the content so far
+	 */
+	uint64 HashContent(uint64 Hash, const uint8* Data, int64 Size)
+	{
+		for (int64 Offset = 0; Offset < Size; Offset += StreamingChunkSize)
+		{
+			Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Data + Offset), static_cast<uint32>(FMath::Min<int64>(Size - Offset, StreamingChunkSize)), Hash);
+		}
+
+		return Hash;
+	}
+
+	/** Maximum size of a vacated region covered by a single header. Readers such as GNU tar load the whole data of an extended header into memory */
+	constexpr int64 MaxVacatedRecordSize = 1024 * 1024;
+
+	/** Identifier of the tar index file format */
+	constexpr uint32 IndexFileMagic = 0x49544152;
+
+	/** Version of the tar index file format. Index files of other versions are ignored */
+	constexpr uint32 IndexFileVersion = 2;
+
+	/** Size of the archive head and tail hashed into the fingerprint of the index file */
+	constexpr int64 FingerprintSpanSize = 64 * 1024;
+
+	/**
+	 * Serialize the entry record to or from the index file
+	 */
+	void SerializeEntryRecord(FArchive& Archive, FRuntimeArchiverTarEntryRecord& Record)
+	{
+		Archive << Record.Name;
+		Archive << Record.HeaderOffset;
+		Archive << Record.DataOffset;
+		Archive << Record.Size;
+		Archive << Record.RealSize;
+		Archive << Record.LinkName;
+
+		int32 NumOfSparseRegions = Record.SparseRegions.Num();
+		Archive << NumOfSparseRegions;
+
+		if (Archive.IsLoading())
+		{
+			// Each region takes 16 bytes, which bounds the number of regions a damaged file can claim
+			if (NumOfSparseRegions < 0 || NumOfSparseRegions > (Archive.TotalSize() - Archive.Tell()) / 16)
+			{
+				Archive.SetError();
+				return;
+			}
+
+			Record.SparseRegions.SetNum(NumOfSparseRegions);
+		}
+
+		for (FRuntimeArchiverTarSparseRegion& Region : Record.SparseRegions)
+		{
+			Archive << Region.Offset;
+			Archive << Region.Size;
+		}
+	}
+
+	/**
+	 * Reads the archive data at arbitrary offsets through the positional reads of the encapsulator stream, without moving its position. Each extraction worker owns its own reader
+	 */
+	class FTarPositionalReader
+	{
+	public:
+		FTarPositionalReader(FRuntimeArchiverBaseStream& InStream, TArrayView64<const uint8> InArchiveMemory)
+			: Stream(InStream)
+		  , ArchiveMemory(InArchiveMemory)
+		{
+			if (ArchiveMemory.Num() == 0)
+			{
+				Buffer.SetNumUninitialized(StreamingChunkSize);
+			}
+		}
+
+		bool IsValid() const
+		{
+			return Stream.IsValid();
+		}
+
+		/**
+		 * Read the specified range of the archive data
+		 *
+		 * @param Offset Offset of the data in the archive
+		 * @param Data Buffer to read the data into
+		 * @param Size Data size
+		 * @return Whether the operation was successful or not
+		 */
+		bool Read(int64 Offset, uint8* Data, int64 Size)
+		{
+			return Stream.ReadAt(Offset, Data, Size);
+		}
+
+		/**
+		 * Copy the specified range of the archive data to the file
+		 *
+		 * @param Offset Offset of the data in the archive
+		 * @param Size Data size
+		 * @param Destination File to write the data to
+		 * @param Checksum Checksum to update with the copied data. Not computed if nullptr
+		 * @return Whether the operation was successful or not
+		 */
+		bool CopyTo(int64 Offset, int64 Size, IFileHandle& Destination, uint32* Checksum)
+		{
+			// In-memory archives are written directly, without an intermediate copy
+			if (ArchiveMemory.Num() > 0)
+			{
+				if (Offset + Size > ArchiveMemory.Num() || !Destination.Write(ArchiveMemory.GetData() + Offset, Size))
+				{
+					return false;
+				}
+
+				if (Checksum)
+				{
+					*Checksum = FRuntimeArchiverHashingStream::UpdateChecksum(*Checksum, ArchiveMemory.GetData() + Offset, Size);
+				}
+
+				return true;
+			}
+
+			while (Size > 0)
+			{
+				const int64 ChunkSize = FMath::Min<int64>(Size, Buffer.Num());
+
+				if (!Read(Offset, Buffer.GetData(), ChunkSize) || !Destination.Write(Buffer.GetData(), ChunkSize))
+				{
+					return false;
+				}
+
+				if (Checksum)
+				{
+					*Checksum = FRuntimeArchiverHashingStream::UpdateChecksum(*Checksum, Buffer.GetData(), ChunkSize);
+				}
+
+				Offset += ChunkSize;
+				Size -= ChunkSize;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Copy the regions of a sparse entry to the file, seeking over the holes
+		 *
+		 * @param DataOffset Offset of the entry data in the archive, where the regions are stored one after another
+		 * @param RealSize Entry content size, including the holes
+		 * @param SparseRegions Regions of the content that contain data
+		 * @param Destination File to write the content to
+		 * @param Checksum Checksum to update with the copied regions. Not computed if nullptr
+		 * @return Whether the operation was successful or not
+		 */
+		bool CopySparseTo(int64 DataOffset, int64 RealSize, const TArray<FRuntimeArchiverTarSparseRegion>& SparseRegions, IFileHandle& Destination, uint32* Checksum)
+		{
+			int64 ContentEnd = 0;
+
+			for (const FRuntimeArchiverTarSparseRegion& Region : SparseRegions)
+			{
+				// Empty regions only denote the content size
+				if (Region.Size == 0)
+				{
+					continue;
+				}
+
+				if (!Destination.Seek(Region.Offset) || !CopyTo(DataOffset, Region.Size, Destination, Checksum))
+				{
+					return false;
+				}
+
+				DataOffset += Region.Size;
+				ContentEnd = Region.Offset + Region.Size;
+			}
+
+			// Seeking alone does not extend the file, so a trailing hole is completed by writing its last byte
+			if (ContentEnd < RealSize)
+			{
+				const uint8 NullByte = 0;
+				return Destination.Seek(RealSize - 1) && Destination.Write(&NullByte, 1);
+			}
+
+			return true;
+		}
+
+	private:
+		/** Stream the archive is read from */
+		FRuntimeArchiverBaseStream& Stream;
+
+		/** Archive data for archives opened in memory or memory-mapped. Empty for other archives */
+		TArrayView64<const uint8> ArchiveMemory;
+
+		/** Buffer used to copy the data from the file */
+		TArray64<uint8> Buffer;
+	};
+
+	/**
+	 * File entry to be extracted by a worker
+	 */
+	struct FTarExtractionJob
+	{
+		/** Entry name */
+		FString EntryName;
+
+		/** Path to the file to extract to */
+		FString FilePath;
+
+		/** Offset of the entry data in the archive */
+		int64 DataOffset;
+
+		/** Entry data size */
+		int64 Size;
+
+		/** Entry content size, including the holes of a sparse entry */
+		int64 RealSize;
+
+		/** Regions of a sparse entry. Empty for regular entries */
+		TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+		/** Index of the entry holding the data, which differs from the extracted entry for hard links */
+		int32 Index;
+	};
+
+	/**
+	 * Open the file to extract the entry to, creating its directory
+	 *
+	 * @param Job Entry to be extracted
+	 * @param bForceOverwrite Whether to overwrite the existing file
+	 * @return File handle, or nullptr if the file cannot be opened
+	 */
+	TUniquePtr<IFileHandle> OpenExtractionFile(const FTarExtractionJob& Job, bool bForceOverwrite)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+		if (!bForceOverwrite && PlatformFile.FileExists(*Job.FilePath))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("File '%s' already exists"), *Job.FilePath);
+			return nullptr;
+		}
+
+		const FString FileDirectoryPath = FPaths::GetPath(Job.FilePath);
+		if (!FileDirectoryPath.IsEmpty() && !PlatformFile.CreateDirectoryTree(*FileDirectoryPath))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to create subdirectory '%s' to extract entry '%s'"), *FileDirectoryPath, *Job.EntryName);
+			return nullptr;
+		}
+
+		return TUniquePtr<IFileHandle>(PlatformFile.OpenWrite(*Job.FilePath));
+	}
+
+	/**
+	 * Chunk of entry data read ahead of the extraction
+	 */
+	struct FTarPrefetchedChunk
+	{
+		/** Index of the extraction job the chunk belongs to */
+		int32 JobIndex;
+
+		/** Offset of the chunk in the entry content */
+		int64 ContentOffset;
+
+		/** Chunk data. Empty for the entries without data */
+		TArray64<uint8> Data;
+	};
+
+	/**
+	 * Queue of the chunks passed from the task reading the archive to the task writing the entries. The total size of the queued chunks is bounded by the prefetch window
+	 */
+	class FTarPrefetchQueue
+	{
+	public:
+		explicit FTarPrefetchQueue(int64 InWindowSize)
+			: WindowSize(InWindowSize)
+		  , QueuedSize(0)
+		  , bIsClosed(false)
+		  , ChunkPushedEvent(FPlatformProcess::GetSynchEventFromPool())
+		  , ChunkPoppedEvent(FPlatformProcess::GetSynchEventFromPool())
+		{
+		}
+
+		~FTarPrefetchQueue()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(ChunkPushedEvent);
+			FPlatformProcess::ReturnSynchEventToPool(ChunkPoppedEvent);
+		}
+
+		/**
+		 * Add the chunk to the queue, waiting while the queued chunks fill the window. The chunk is accepted into an empty queue regardless of its size
+		 *
+		 * @param Chunk Chunk to add
+		 * @return Whether the chunk was added, or the queue was closed
+		 */
+		bool Push(FTarPrefetchedChunk&& Chunk)
+		{
+			for (;;)
+			{
+				{
+					FScopeLock Lock(&CriticalSection);
+
+					if (bIsClosed)
+					{
+						return false;
+					}
+
+					if (Chunks.Num() == 0 || QueuedSize + Chunk.Data.Num() <= WindowSize)
+					{
+						QueuedSize += Chunk.Data.Num();
+						Chunks.Add(MoveTemp(Chunk));
+						break;
+					}
+				}
+
+				ChunkPoppedEvent->Wait();
+			}
+
+			ChunkPushedEvent->Trigger();
+			return true;
+		}
+
+		/**
+		 * Take the next chunk from the queue, waiting until one is added
+		 *
+		 * @param Chunk Taken chunk
+		 * @return Whether the chunk was taken, or the queue was closed with no chunks left
+		 */
+		bool Pop(FTarPrefetchedChunk& Chunk)
+		{
+			for (;;)
+			{
+				{
+					FScopeLock Lock(&CriticalSection);
+
+					if (Chunks.Num() > 0)
+					{
+						Chunk = MoveTemp(Chunks[0]);
+						Chunks.RemoveAt(0);
+						QueuedSize -= Chunk.Data.Num();
+						break;
+					}
+
+					if (bIsClosed)
+					{
+						return false;
+					}
+				}
+
+				ChunkPushedEvent->Wait();
+			}
+
+			ChunkPoppedEvent->Trigger();
+			return true;
+		}
+
+		/**
+		 * Stop accepting chunks and wake up the waiting tasks. The chunks already added can still be taken
+		 */
+		void Close()
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				bIsClosed = true;
+			}
+
+			ChunkPushedEvent->Trigger();
+			ChunkPoppedEvent->Trigger();
+		}
+
+		/**
+		 * Return the data buffer of a written chunk so that the next chunks are read into it instead of a new allocation
+		 */
+		void RecycleBuffer(TArray64<uint8>&& Buffer)
+		{
+			FScopeLock Lock(&CriticalSection);
+			FreeBuffers.Add(MoveTemp(Buffer));
+		}
+
+		/**
+		 * Get a data buffer for the next chunk, reusing a recycled one if possible
+		 */
+		TArray64<uint8> TakeBuffer()
+		{
+			FScopeLock Lock(&CriticalSection);
+			return FreeBuffers.Num() > 0 ? FreeBuffers.Pop() : TArray64<uint8>();
+		}
+
+	private:
+		/** Maximum total size of the queued chunks */
+		int64 WindowSize;
+
+		/** Total size of the queued chunks */
+		int64 QueuedSize;
+
+		/** Whether the queue no longer accepts chunks */
+		bool bIsClosed;
+
+		/** Queued chunks, in the order they were added */
+		TArray<FTarPrefetchedChunk> Chunks;
+
+		/** Buffers of the written chunks */
+		TArray<TArray64<uint8>> FreeBuffers;
+
+		/** Lock guarding the queue state */
+		FCriticalSection CriticalSection;
+
+		/** Triggered when a chunk is added or the queue is closed */
+		FEvent* ChunkPushedEvent;
+
+		/** Triggered when a chunk is taken or the queue is closed */
+		FEvent* ChunkPoppedEvent;
+	};
+
+	/**
+	 * Extract the entries one at a time, reading the data of the next entries on another task while the data read before is written to storage
+	 *
+	 * @param FileJobs Entries to be extracted, in archive order
+	 * @param Stream Stream the archive is read from
+	 * @param WindowSize Maximum size of the data read ahead, in bytes
+	 * @param bForceOverwrite Whether to overwrite the existing files
+	 * @param bComputeChecksums Whether to compute the checksums of the extracted data
+	 * @param OnEntryExtracted Called after each extracted entry with its job index and the checksum of its data, which is 0 if the checksums are not computed
+	 * @param FailedJobIndex Index of the entry that failed to be extracted
+	 * @return Whether the operation was successful or not
+	 */
+	bool ExtractWithPrefetch(const TArray<FTarExtractionJob>& FileJobs, FRuntimeArchiverBaseStream& Stream, int64 WindowSize, bool bForceOverwrite, bool bComputeChecksums, TFunctionRef<void(int32 JobIndex, uint32 Checksum)> OnEntryExtracted, int32& FailedJobIndex)
+	{
+		FailedJobIndex = INDEX_NONE;
+
+		FTarPositionalReader Reader(Stream, TArrayView64<const uint8>());
+
+		if (!Reader.IsValid())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar archive for prefetching"));
+			return false;
+		}
+
+		// At least two chunks fit into the window, so that one is read while the other is written
+		const int64 ChunkSize = FMath::Max<int64>(FMath::Min<int64>(WindowSize / 2, StreamingChunkSize), 1);
+
+		FTarPrefetchQueue Queue(WindowSize);
+		std::atomic<int32> FailedReadJobIndex{INDEX_NONE};
+
+		TFuture<void> ReadFuture = Async(EAsyncExecution::ThreadPool, [&FileJobs, &Reader, &Queue, &FailedReadJobIndex, ChunkSize]()
+		{
+			for (int32 JobIndex = 0; JobIndex < FileJobs.Num(); ++JobIndex)
+			{
+				const FTarExtractionJob& Job = FileJobs[JobIndex];
+
+				// Regular entries are a single region covering the whole content
+				TArray<FRuntimeArchiverTarSparseRegion> Regions = Job.SparseRegions;
+				if (Regions.Num() == 0)
+				{
+					Regions.Add(FRuntimeArchiverTarSparseRegion{0, Job.Size});
+				}
+
+				int64 DataOffset = Job.DataOffset;
+				bool bIsChunkPushed = false;
+
+				for (const FRuntimeArchiverTarSparseRegion& Region : Regions)
+				{
+					for (int64 RegionOffset = 0; RegionOffset < Region.Size; RegionOffset += ChunkSize)
+					{
+						FTarPrefetchedChunk Chunk{JobIndex, Region.Offset + RegionOffset, Queue.TakeBuffer()};
+						Chunk.Data.SetNumUninitialized(FMath::Min<int64>(ChunkSize, Region.Size - RegionOffset), false);
+
+						if (!Reader.Read(DataOffset, Chunk.Data.GetData(), Chunk.Data.Num()))
+						{
+							FailedReadJobIndex = JobIndex;
+							Queue.Close();
+							return;
+						}
+
+						DataOffset += Chunk.Data.Num();
+
+						if (!Queue.Push(MoveTemp(Chunk)))
+						{
+							return;
+						}
+
+						bIsChunkPushed = true;
+					}
+				}
+
+				// The entries without data still need their files to be created
+				if (!bIsChunkPushed && !Queue.Push(FTarPrefetchedChunk{JobIndex, 0, TArray64<uint8>()}))
+				{
+					return;
+				}
+			}
+
+			Queue.Close();
+		});
+
+		int32 JobIndex = INDEX_NONE;
+		TUniquePtr<IFileHandle> FileHandle;
+		int64 ContentEnd = 0;
+		uint32 Checksum = 0;
+
+		// Seeking alone does not extend the file, so a trailing hole is completed by writing its last byte
+		auto FinishFile = [&]()
+		{
+			const int64 RealSize = FileJobs[JobIndex].RealSize;
+			const uint8 NullByte = 0;
+
+			if (ContentEnd < RealSize && (!FileHandle->Seek(RealSize - 1) || !FileHandle->Write(&NullByte, 1)))
+			{
+				return false;
+			}
+
+			FileHandle.Reset();
+			OnEntryExtracted(JobIndex, Checksum);
+			return true;
+		};
+
+		bool bSuccess = [&]()
+		{
+			FTarPrefetchedChunk Chunk;
+
+			while (Queue.Pop(Chunk))
+			{
+				if (Chunk.JobIndex != JobIndex)
+				{
+					if (JobIndex != INDEX_NONE && !FinishFile())
+					{
+						return false;
+					}
+
+					JobIndex = Chunk.JobIndex;
+					ContentEnd = 0;
+					Checksum = 0;
+					FileHandle = OpenExtractionFile(FileJobs[JobIndex], bForceOverwrite);
+
+					if (!FileHandle.IsValid())
+					{
+						return false;
+					}
+				}
+
+				// The holes of sparse entries are skipped by seeking
+				if (Chunk.Data.Num() > 0)
+				{
+					if ((FileHandle->Tell() != Chunk.ContentOffset && !FileHandle->Seek(Chunk.ContentOffset)) || !FileHandle->Write(Chunk.Data.GetData(), Chunk.Data.Num()))
+					{
+						return false;
+					}
+
+					ContentEnd = Chunk.ContentOffset + Chunk.Data.Num();
+
+					if (bComputeChecksums)
+					{
+						Checksum = FRuntimeArchiverHashingStream::UpdateChecksum(Checksum, Chunk.Data.GetData(), Chunk.Data.Num());
+					}
+				}
+
+				Queue.RecycleBuffer(MoveTemp(Chunk.Data));
+			}
+
+			if (FailedReadJobIndex != INDEX_NONE)
+			{
+				JobIndex = FailedReadJobIndex;
+				return false;
+			}
+
+			return JobIndex == INDEX_NONE || FinishFile();
+		}();
+
+		// Stops the reading task if the extraction failed before all chunks were read
+		Queue.Close();
+		ReadFuture.Wait();
+
+		if (!bSuccess)
+		{
+			FailedJobIndex = JobIndex;
+		}
+
+		return bSuccess;
+	}
+
+	/**
+	 * Detects runs of zero blocks in content passed in sequential chunks and builds the sparse map of the remaining data
+	 */
+	class FTarSparseMapBuilder
+	{
+	public:
+		/**
+		 * @param InThreshold Minimum size of a run of zeros to be treated as a hole. Rounded up to the tar block size
+		 */
+		explicit FTarSparseMapBuilder(int64 InThreshold)
+			: Threshold{RuntimeArchiverTarOperations::RoundUp<int64>(FMath::Max<int64>(InThreshold, 1), BlockSize)}
+		  , Position{0}
+		  , DataStart{0}
+		  , ZeroRunStart{INDEX_NONE}
+		  , bIsBlockZero{true}
+		{
+		}
+
+		/**
+		 * Scan the next chunk of the content
+		 */
+		void Append(const uint8* Data, int64 Size)
+		{
+			while (Size > 0)
+			{
+				const int64 ChunkSize = FMath::Min<int64>(Size, BlockSize - Position % BlockSize);
+
+				bIsBlockZero = bIsBlockZero && IsZero(Data, ChunkSize);
+				Position += ChunkSize;
+				Data += ChunkSize;
+				Size -= ChunkSize;
+
+				if (Position % BlockSize == 0)
+				{
+					AddBlock(Position - BlockSize, bIsBlockZero);
+					bIsBlockZero = true;
+				}
+			}
+		}
+
+		/**
+		 * Complete the scan
+		 *
+		 * @param Regions Regions of the content that contain data. Only filled if the content has holes
+		 * @return Whether the content has holes or not
+		 */
+		bool Finish(TArray<FRuntimeArchiverTarSparseRegion>& Regions)
+		{
+			// The last partial block is treated the same way as the full ones
+			if (Position % BlockSize != 0)
+			{
+				AddBlock(Position - Position % BlockSize, bIsBlockZero);
+			}
+
+			if (ZeroRunStart != INDEX_NONE && Position - ZeroRunStart >= Threshold)
+			{
+				AddRegion(DataStart, ZeroRunStart);
+
+				// Like GNU tar, a trailing hole is denoted by an empty region at the end of the content
+				SparseRegions.Add(FRuntimeArchiverTarSparseRegion{Position, 0});
+			}
+			else
+			{
+				AddRegion(DataStart, Position);
+			}
+
+			int64 StoredSize = 0;
+			for (const FRuntimeArchiverTarSparseRegion& Region : SparseRegions)
+			{
+				StoredSize += Region.Size;
+			}
+
+			if (StoredSize == Position)
+			{
+				return false;
+			}
+
+			Regions = MoveTemp(SparseRegions);
+			return true;
+		}
+
+	private:
+		static constexpr int64 BlockSize = 512;
+
+		static bool IsZero(const uint8* Data, int64 Size)
+		{
+			uint64 Accumulator = 0;
+			int64 Index = 0;
+
+			for (; Index + static_cast<int64>(sizeof(uint64)) <= Size; Index += sizeof(uint64))
+			{
+				uint64 Word;
+				FMemory::Memcpy(&Word, Data + Index, sizeof(uint64));
+				Accumulator |= Word;
+			}
+
+			for (; Index < Size; ++Index)
+			{
+				Accumulator |= Data[Index];
+			}
+
+			return Accumulator == 0;
+		}
+
+		void AddBlock(int64 BlockStart, bool bIsZero)
+		{
+			if (bIsZero)
+			{
+				if (ZeroRunStart == INDEX_NONE)
+				{
+					ZeroRunStart = BlockStart;
+				}
+				return;
+			}
+
+			// The data resumes after a run of zeros long enough to become a hole
+			if (ZeroRunStart != INDEX_NONE && BlockStart - ZeroRunStart >= Threshold)
+			{
+				AddRegion(DataStart, ZeroRunStart);
+				DataStart = BlockStart;
+			}
+
+			ZeroRunStart = INDEX_NONE;
+		}
+
+		void AddRegion(int64 Start, int64 End)
+		{
+			if (End > Start)
+			{
+				SparseRegions.Add(FRuntimeArchiverTarSparseRegion{Start, End - Start});
+			}
+		}
+
+		/** Minimum hole size */
+		int64 Threshold;
+
+		/** Size of the content scanned so far */
+		int64 Position;
+
+		/** Start of the current data region */
+		int64 DataStart;
+
+		/** Start of the current run of zero blocks, or INDEX_NONE */
+		int64 ZeroRunStart;
+
+		/** Whether the current block contains only zeros so far */
+		bool bIsBlockZero;
+
+		/** Regions found so far */
+		TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+	};
+}
+
+URuntimeArchiverTar::URuntimeArchiverTar()
+	: WriteBufferSize(1024 * 1024)
+  , FileBufferSize(FRuntimeArchiverFileStream::DefaultBufferSize)
+  , bMemoryMapArchive(false)
+  , NumOfAsyncReadRequests(0)
+  , AsyncReadRequestSize(FRuntimeArchiverAsyncFileStream::DefaultRequestSize)
+  , NumOfExtractionWorkers(1)
+  , PrefetchWindowSize(0)
+  , SparseThreshold(0)
+  , bDeduplicateEntries(false)
+  , bUseIndexFile(false)
+  , MaxVolumeSize(0)
+  , bComputeChecksums(false)
+{
+}
+
+bool URuntimeArchiverTar::CreateArchiveInStorage(FString ArchivePath)
+{
+	if (!Super::CreateArchiveInStorage(ArchivePath))
+	{
+		return false;
+	}
+
+	FPaths::NormalizeFilename(ArchivePath);
+
+	if (MaxVolumeSize > 0 ? !TarEncapsulator->CreateVolumes(ArchivePath, MaxVolumeSize) : !TarEncapsulator->OpenFile(ArchivePath, true))
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open tar archive '%s' for writing"), *ArchivePath));
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully created tar archive '%s' in '%s'"), *GetName(), *ArchivePath);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::CreateArchiveInMemory(int32 InitialAllocationSize)
+{
+	if (!Super::CreateArchiveInMemory(InitialAllocationSize))
+	{
+		return false;
+	}
+
+	if (!TarEncapsulator->OpenMemory(TArray64<uint8>(), InitialAllocationSize, true))
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Unable to initialize tar archive in memory"));
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully created tar archive '%s' in memory"), *GetName());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromStorage(FString ArchivePath)
+{
+	if (!Super::OpenArchiveFromStorage(ArchivePath))
+	{
+		return false;
+	}
+
+	FPaths::NormalizeFilename(ArchivePath);
+
+	if (!TarEncapsulator->OpenFile(ArchivePath, false))
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open tar archive '%s' for writing"), *ArchivePath));
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully opened tar archive '%s' in '%s' to read"), *GetName(), *ArchivePath);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromStorageToAppend(FString ArchivePath)
+{
+	if (!Initialize())
+	{
+		return false;
+	}
+
+	FPaths::NormalizeFilename(ArchivePath);
+
+	if (ArchivePath.IsEmpty() || !FPaths::FileExists(ArchivePath))
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Archive '%s' does not exist"), *ArchivePath));
+		Reset();
+		return false;
+	}
+
+	Mode = ERuntimeArchiverMode::Write;
+	Location = ERuntimeArchiverLocation::Storage;
+
+	if (!TarEncapsulator->OpenFileToAppend(ArchivePath))
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open tar archive '%s' to append"), *ArchivePath));
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully opened tar archive '%s' in '%s' to append"), *GetName(), *ArchivePath);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::OpenArchiveVolumesFromStorage(TArray<FString> VolumePaths)
+{
+	if (VolumePaths.Num() == 0)
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, TEXT("Archive volumes not specified"));
+		return false;
+	}
+
+	for (FString& VolumePath : VolumePaths)
+	{
+		FPaths::NormalizeFilename(VolumePath);
+
+		if (VolumePath.IsEmpty() || !FPaths::FileExists(VolumePath))
+		{
+			ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Archive volume '%s' does not exist"), *VolumePath));
+			return false;
+		}
+	}
+
+	if (!Initialize())
+	{
+		return false;
+	}
+
+	Mode = ERuntimeArchiverMode::Read;
+	Location = ERuntimeArchiverLocation::Storage;
+
+	if (!TarEncapsulator->OpenVolumes(VolumePaths))
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open %d tar archive volumes starting with '%s' to read"), VolumePaths.Num(), *VolumePaths[0]));
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully opened tar archive '%s' from %d volumes starting with '%s' to read"), *GetName(), VolumePaths.Num(), *VolumePaths[0]);
+
+	return true;
+}
+
+FString URuntimeArchiverTar::GetVolumePath(FString ArchivePath, int32 VolumeIndex)
+{
+	return FRuntimeArchiverVolumeStream::GetVolumePath(ArchivePath, VolumeIndex);
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromMemory(const TArray64<uint8>& ArchiveData)
+{
+	return OpenArchiveFromMemoryStream(MakeUnique<FRuntimeArchiverMemoryStream>(ArchiveData));
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromMemory(TArray64<uint8>&& ArchiveData)
+{
+	return OpenArchiveFromMemoryStream(MakeUnique<FRuntimeArchiverMemoryStream>(MoveTemp(ArchiveData)));
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromMemory(TArrayView64<const uint8> ArchiveData)
+{
+	return OpenArchiveFromMemoryStream(MakeUnique<FRuntimeArchiverMemoryStream>(ArchiveData));
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromMemory(TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> ArchiveData)
+{
+	return OpenArchiveFromMemoryStream(MakeUnique<FRuntimeArchiverMemoryStream>(MoveTemp(ArchiveData)));
+}
+
+bool URuntimeArchiverTar::OpenArchiveFromMemoryStream(TUniquePtr<FRuntimeArchiverMemoryStream> MemoryStream)
+{
+	// The base archiver does not use the data, the archive is read by the stream
+	if (!Super::OpenArchiveFromMemory(TArray64<uint8>()))
+	{
+		return false;
+	}
+
+	if (!TarEncapsulator->OpenMemory(MoveTemp(MemoryStream)))
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Unable to open in-memory tar archive to read"));
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully opened in-memory tar archive '%s' to read"), *GetName());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::CloseArchive()
+{
+	if (!Super::CloseArchive())
+	{
+		return false;
+	}
+
+	Reset();
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully closed tar archive '%s'"), *GetName());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::GetArchiveData(TArray64<uint8>& ArchiveData)
+{
+	if (!Super::GetArchiveData(ArchiveData))
+	{
+		return false;
+	}
+
+	const bool bSuccess = TarEncapsulator->GetArchiveData(ArchiveData);
+
+	if (!bSuccess)
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get tar archive data from memory"));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar archive data from memory with size '%lld'"), ArchiveData.Num());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::GetArchiveEntries(int32& NumOfArchiveEntries)
+{
+	if (!Super::GetArchiveEntries(NumOfArchiveEntries))
+	{
+		return false;
+	}
+
+	if (!TarEncapsulator->GetArchiveEntries(NumOfArchiveEntries))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get number of tar entries"));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved %d tar entries"), NumOfArchiveEntries);
+	return true;
+}
+
+bool URuntimeArchiverTar::GetArchiveEntryInfoByName(FString EntryName, FRuntimeArchiveEntry& EntryInfo)
+{
+	if (!Super::GetArchiveEntryInfoByName(EntryName, EntryInfo))
+	{
+		return false;
+	}
+
+	int32 EntryIndex;
+
+	// Searching for the entry index by the entry name
+	if (!TarEncapsulator->FindEntryIndex(EntryName, EntryIndex))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Unable to find the entry index under the entry name '%s'"), *EntryName));
+		return false;
+	}
+
+	FTarHeader Header;
+
+	if (!TarEncapsulator->ReadHeaderByIndex(EntryIndex, Header, true))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Unable to read tar header with entry name '%s'"), *EntryName));
+		return false;
+	}
+
+	if (!FTarHeader::ToEntry(Header, EntryIndex, EntryInfo))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Failed to convert tar header to entry with entry name '%s'"), *EntryName));
+		return false;
+	}
+
+	// Hard links report the size and checksum of the content they point to
+	int32 DataIndex = EntryIndex;
+	FRuntimeArchiverTarEntryRecord DataRecord;
+	if (Header.IsHardLink() && TarEncapsulator->ResolveHardLink(DataIndex) && TarEncapsulator->GetEntryRecord(DataIndex, DataRecord))
+	{
+		EntryInfo.UncompressedSize = DataRecord.RealSize;
+	}
+
+	EntryInfo.Checksum = TarEncapsulator->GetEntryChecksum(DataIndex);
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar entry '%s' by name"), *EntryInfo.Name);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::GetArchiveEntryInfoByIndex(int32 EntryIndex, FRuntimeArchiveEntry& EntryInfo)
+{
+	if (!Super::GetArchiveEntryInfoByIndex(EntryIndex, EntryInfo))
+	{
+		return false;
+	}
+
+	FTarHeader Header;
+
+	if (!TarEncapsulator->ReadHeaderByIndex(EntryIndex, Header, true))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Unable to find tar header at index %d"), EntryIndex));
+		return false;
+	}
+
+	if (!FTarHeader::ToEntry(Header, EntryIndex, EntryInfo))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Failed to convert tar header to entry with entry index '%d'"), EntryIndex));
+		return false;
+	}
+
+	// Hard links report the size and checksum of the content they point to
+	int32 DataIndex = EntryIndex;
+	FRuntimeArchiverTarEntryRecord DataRecord;
+	if (Header.IsHardLink() && TarEncapsulator->ResolveHardLink(DataIndex) && TarEncapsulator->GetEntryRecord(DataIndex, DataRecord))
+	{
+		EntryInfo.UncompressedSize = DataRecord.RealSize;
+	}
+
+	EntryInfo.Checksum = TarEncapsulator->GetEntryChecksum(DataIndex);
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar entry '%s' by index"), *EntryInfo.Name);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::AddEntryFromMemory(FString EntryName, const TArray64<uint8>& DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel)
+{
+	if (!Super::AddEntryFromMemory(EntryName, DataToBeArchived, CompressionLevel))
+	{
+		return false;
+	}
+
+	if (!WriteParentDirectoryEntries(EntryName))
+	{
+		return false;
+	}
+
+	const bool bDeduplicate = bDeduplicateEntries && DataToBeArchived.Num() > 0;
+	const uint64 ContentHash = bDeduplicate ? HashContent(0, DataToBeArchived.GetData(), DataToBeArchived.Num()) : 0;
+
+	if (bDeduplicate)
+	{
+		FString TargetName;
+
+		const bool bIsDuplicate = FindDuplicateEntry(ContentHash, DataToBeArchived.Num(), [&DataToBeArchived](int64 Offset, uint8* Data, int64 ChunkSize)
+		{
+			FMemory::Memcpy(Data, DataToBeArchived.GetData() + Offset, ChunkSize);
+			return true;
+		}, TargetName);
+
+		if (bIsDuplicate)
+		{
+			return WriteHardLinkEntry(EntryName, TargetName);
+		}
+	}
+
+	TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+	// GNU tar cannot continue sparse entries in the next volume, so volumes only hold regular entries
+	const int32 EntrySparseThreshold = TarEncapsulator->IsMultiVolume() ? 0 : SparseThreshold;
+
+	if (EntrySparseThreshold > 0)
+	{
+		FTarSparseMapBuilder SparseMapBuilder(EntrySparseThreshold);
+		SparseMapBuilder.Append(DataToBeArchived.GetData(), DataToBeArchived.Num());
+		SparseMapBuilder.Finish(SparseRegions);
+	}
+
+	// Archiving data
+	{
+		if (!WriteFileHeader(EntryName, DataToBeArchived.Num(), SparseRegions))
+		{
+			return false;
+		}
+
+		bool bSuccess = true;
+
+		if (SparseRegions.Num() == 0)
+		{
+			bSuccess = TarEncapsulator->WriteData(DataToBeArchived);
+		}
+
+		// Only the data regions are stored, the holes are skipped
+		for (const FRuntimeArchiverTarSparseRegion& Region : SparseRegions)
+		{
+			bSuccess = bSuccess && TarEncapsulator->WriteData(DataToBeArchived.GetData() + Region.Offset, Region.Size);
+		}
+
+		if (!bSuccess)
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write data for entry '%s' from memory"), *EntryName));
+			return false;
+		}
+	}
+
+	if (bDeduplicate)
+	{
+		TarEncapsulator->AddContentHash(ContentHash);
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully added tar entry '%s' with size %lld bytes from memory"), *EntryName, DataToBeArchived.Num());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::AddFileEntryFromStorage(const FString& EntryName, const FString& FilePath, ERuntimeArchiverCompressionLevel CompressionLevel)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenRead(*FilePath));
+
+	if (!FileHandle.IsValid())
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to open file '%s' for entry '%s'"), *FilePath, *EntryName));
+		return false;
+	}
+
+	// The size is known in advance, so the header can be written before the data
+	const int64 FileSize = FileHandle->Size();
+
+	if (FileSize < 0)
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to get the size of file '%s' for entry '%s'"), *FilePath, *EntryName));
+		return false;
+	}
+
+	if (!WriteParentDirectoryEntries(EntryName))
+	{
+		return false;
+	}
+
+	// The file data is copied through a bounded buffer, so the memory usage does not depend on the file size
+	TArray64<uint8> Buffer;
+	Buffer.SetNumUninitialized(FMath::Min<int64>(FileSize, StreamingChunkSize));
+
+	const bool bDeduplicate = bDeduplicateEntries && FileSize > 0;
+	uint64 ContentHash = 0;
+	TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+	// Volumes only hold regular entries, as in AddEntryFromMemory
+	const int32 EntrySparseThreshold = TarEncapsulator->IsMultiVolume() ? 0 : SparseThreshold;
+
+	// The sparse map is part of the header and duplicates are written as links instead, so the content is analyzed in a separate pass before any data is written
+	if (EntrySparseThreshold > 0 || bDeduplicate)
+	{
+		FTarSparseMapBuilder SparseMapBuilder(EntrySparseThreshold);
+
+		for (int64 RemainingSize = FileSize; RemainingSize > 0;)
+		{
+			const int64 ChunkSize = FMath::Min<int64>(RemainingSize, Buffer.Num());
+
+			if (!FileHandle->Read(Buffer.GetData(), ChunkSize))
+			{
+				ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to read file '%s' for entry '%s'"), *FilePath, *EntryName));
+				return false;
+			}
+
+			if (EntrySparseThreshold > 0)
+			{
+				SparseMapBuilder.Append(Buffer.GetData(), ChunkSize);
+			}
+
+			if (bDeduplicate)
+			{
+				ContentHash = HashContent(ContentHash, Buffer.GetData(), ChunkSize);
+			}
+
+			RemainingSize -= ChunkSize;
+		}
+
+		if (EntrySparseThreshold > 0)
+		{
+			SparseMapBuilder.Finish(SparseRegions);
+		}
+	}
+
+	if (bDeduplicate)
+	{
+		FString TargetName;
+
+		const bool bIsDuplicate = FindDuplicateEntry(ContentHash, FileSize, [&FileHandle](int64 Offset, uint8* Data, int64 ChunkSize)
+		{
+			return FileHandle->Seek(Offset) && FileHandle->Read(Data, ChunkSize);
+		}, TargetName);
+
+		if (bIsDuplicate)
+		{
+			return WriteHardLinkEntry(EntryName, TargetName);
+		}
+	}
+
+	if (!WriteFileHeader(EntryName, FileSize, SparseRegions))
+	{
+		return false;
+	}
+
+	auto CopyFileRange = [this, &FileHandle, &Buffer, &EntryName, &FilePath](int64 Offset, int64 Size)
+	{
+		if (!FileHandle->Seek(Offset))
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to seek to offset %lld in file '%s' for entry '%s'"), Offset, *FilePath, *EntryName));
+			return false;
+		}
+
+		for (int64 RemainingSize = Size; RemainingSize > 0;)
+		{
+			const int64 ChunkSize = FMath::Min<int64>(RemainingSize, Buffer.Num());
+
+			if (!FileHandle->Read(Buffer.GetData(), ChunkSize))
+			{
+				ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to read file '%s' for entry '%s'"), *FilePath, *EntryName));
+				return false;
+			}
+
+			if (!TarEncapsulator->WriteData(Buffer.GetData(), ChunkSize))
+			{
+				ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write data for entry '%s' from file '%s'"), *EntryName, *FilePath));
+				return false;
+			}
+
+			RemainingSize -= ChunkSize;
+		}
+
+		return true;
+	};
+
+	bool bSuccess = SparseRegions.Num() > 0 || CopyFileRange(0, FileSize);
+
+	// Only the data regions are stored, the holes are skipped
+	for (const FRuntimeArchiverTarSparseRegion& Region : SparseRegions)
+	{
+		bSuccess = bSuccess && CopyFileRange(Region.Offset, Region.Size);
+	}
+
+	// The header already promises the whole file, so a partially copied entry is abandoned to keep the rest of the archive consistent
+	if (!bSuccess)
+	{
+		if (!TarEncapsulator->AbandonEntryData())
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to abandon partially written entry '%s'. The archive may be corrupted"), *EntryName));
+		}
+
+		return false;
+	}
+
+	if (bDeduplicate)
+	{
+		TarEncapsulator->AddContentHash(ContentHash);
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully added tar entry '%s' with size %lld bytes from file '%s'"), *EntryName, FileSize, *FilePath);
+
+	return true;
+}
+
+void URuntimeArchiverTar::ExtractEntriesToStorage(const FRuntimeArchiverAsyncOperationResult& OnResult, const FRuntimeArchiverAsyncOperationProgress& OnProgress, TArray<FRuntimeArchiveEntry> EntryInfo, FString DirectoryPath, bool bForceOverwrite)
+{
+	// Archives in memory and memory-mapped archives are read directly, so there is nothing to prefetch
+	const bool bPrefetch = NumOfExtractionWorkers <= 1 && PrefetchWindowSize > 0 && IsInitialized() && TarEncapsulator->GetArchiveMemory().Num() == 0;
+
+	if (NumOfExtractionWorkers <= 1 && !bPrefetch)
+	{
+		Super::ExtractEntriesToStorage(OnResult, OnProgress, MoveTemp(EntryInfo), MoveTemp(DirectoryPath), bForceOverwrite);
+		return;
+	}
+
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		OnResult.ExecuteIfBound(false);
+		return;
+	}
+
+	if (Mode != ERuntimeArchiverMode::Read)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Only '%s' mode is supported for extracting entries (using mode: '%s')"), *UEnum::GetValueAsName(ERuntimeArchiverMode::Read).ToString(), *UEnum::GetValueAsName(Mode).ToString()));
+		OnResult.ExecuteIfBound(false);
+		return;
+	}
+
+	FPaths::NormalizeDirectoryName(DirectoryPath);
+
+	// Resolving the entry locations upfront so that the workers do not need to access the archiver
+	TArray<FRuntimeArchiveEntry> DirectoryEntries;
+	TArray<FTarExtractionJob> FileJobs;
+
+	for (const FRuntimeArchiveEntry& Entry : EntryInfo)
+	{
+		FString FilePath = Entry.Name;
+		FPaths::NormalizeDirectoryName(FilePath);
+		FilePath = FPaths::Combine(DirectoryPath, TEXT("/"), FilePath);
+
+		if (Entry.bIsDirectory)
+		{
+			DirectoryEntries.Add(Entry);
+			continue;
+		}
+
+		int32 Index;
+		FRuntimeArchiverTarEntryRecord Record;
+
+		if (!TarEncapsulator->FindEntryIndex(Entry.Name, Index) || !TarEncapsulator->ResolveHardLink(Index) || !TarEncapsulator->GetEntryRecord(Index, Record))
+		{
+			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to find tar entry '%s' to extract. Aborting async extracting entries"), *Entry.Name));
+			OnResult.ExecuteIfBound(false);
+			return;
+		}
+
+		FileJobs.Add(FTarExtractionJob{Entry.Name, MoveTemp(FilePath), Record.DataOffset, Record.Size, Record.RealSize, MoveTemp(Record.SparseRegions), Index});
+	}
+
+	const TArray<FRuntimeArchiverVolume> Volumes = TarEncapsulator->GetArchiveVolumes();
+
+	// The prefetching reads the archive from start to end, so that the reads are sequential
+	if (bPrefetch)
+	{
+		FileJobs.Sort([](const FTarExtractionJob& A, const FTarExtractionJob& B)
+		{
+			return A.DataOffset < B.DataOffset;
+		});
+	}
+	// Interleaving the entries of different volumes lets the workers read the volumes located on different drives at the same time
+	else if (Volumes.Num() > 1)
+	{
+		TArray<TArray<FTarExtractionJob>> JobsByVolume;
+		JobsByVolume.SetNum(Volumes.Num());
+
+		for (FTarExtractionJob& Job : FileJobs)
+		{
+			int32 VolumeIndex = Volumes.Num() - 1;
+			while (VolumeIndex > 0 && Job.DataOffset < Volumes[VolumeIndex].Start)
+			{
+				--VolumeIndex;
+			}
+
+			JobsByVolume[VolumeIndex].Add(MoveTemp(Job));
+		}
+
+		const int32 NumOfJobs = FileJobs.Num();
+		FileJobs.Reset();
+
+		for (int32 JobIndex = 0; FileJobs.Num() < NumOfJobs; ++JobIndex)
+		{
+			for (TArray<FTarExtractionJob>& VolumeJobs : JobsByVolume)
+			{
+				if (JobIndex < VolumeJobs.Num())
+				{
+					FileJobs.Add(MoveTemp(VolumeJobs[JobIndex]));
+				}
+			}
+		}
+	}
+
+	const int32 NumOfEntries = EntryInfo.Num();
+	const int32 NumOfWorkers = FMath::Min(NumOfExtractionWorkers, FileJobs.Num());
+	const int64 WindowSize = bPrefetch ? PrefetchWindowSize : 0;
+
+	AsyncTask(ENamedThreads::AnyBackgroundHiPriTask, [WeakThis = MakeWeakObjectPtr(this), OnResult, OnProgress, DirectoryEntries = MoveTemp(DirectoryEntries), FileJobs = MoveTemp(FileJobs), DirectoryPath = MoveTemp(DirectoryPath),
+		Encapsulator = TarEncapsulator, NumOfEntries, NumOfWorkers, WindowSize, bForceOverwrite]()
+	{
+		if (!WeakThis.IsValid())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Failed to extract entries to storage: archiver is no longer valid"));
+			return;
+		}
+
+		// The encapsulator is held by the task, so the stream and the archive data it owns remain valid even if the archiver is closed or destroyed during the extraction
+		FRuntimeArchiverBaseStream* Stream = Encapsulator->GetStream();
+		const TArrayView64<const uint8> ArchiveMemory = Encapsulator->GetArchiveMemory();
+
+		auto ExecuteResult = [OnResult](bool bResult)
+		{
+			AsyncTask(ENamedThreads::GameThread, [OnResult, bResult]()
+			{
+				OnResult.ExecuteIfBound(bResult);
+			});
+		};
+
+		auto ExecuteProgress = [OnProgress](int32 Percentage)
+		{
+			AsyncTask(ENamedThreads::GameThread, [OnProgress, Percentage]()
+			{
+				OnProgress.ExecuteIfBound(Percentage);
+			});
+		};
+
+		std::atomic<int32> NumOfExtractedEntries{0};
+		const bool bComputeChecksums = Encapsulator->IsComputingChecksums();
+
+		// Directories are created first so that the workers only deal with files
+		for (const FRuntimeArchiveEntry& Entry : DirectoryEntries)
+		{
+			FString FilePath = Entry.Name;
+			FPaths::NormalizeDirectoryName(FilePath);
+
+			if (!WeakThis.IsValid())
+			{
+				UE_LOG(LogRuntimeArchiver, Error, TEXT("Failed to extract entries to storage: archiver is no longer valid"));
+				ExecuteResult(false);
+				return;
+			}
+
+			if (!WeakThis->ExtractEntryToStorage(Entry, FPaths::Combine(DirectoryPath, TEXT("/"), FilePath), bForceOverwrite))
+			{
+				WeakThis->ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Cannot extract '%s' entry. Aborting async extracting entries"), *Entry.Name));
+				ExecuteResult(false);
+				return;
+			}
+
+			ExecuteProgress(static_cast<float>(++NumOfExtractedEntries) / NumOfEntries * 100);
+		}
+
+		if (WindowSize > 0)
+		{
+			int32 FailedJobIndex;
+
+			auto OnEntryExtracted = [&](int32 JobIndex, uint32 Checksum)
+			{
+				if (bComputeChecksums)
+				{
+					Encapsulator->SetEntryChecksum(FileJobs[JobIndex].Index, Checksum);
+				}
+
+				ExecuteProgress(static_cast<float>(++NumOfExtractedEntries) / NumOfEntries * 100);
+			};
+
+			if (!ExtractWithPrefetch(FileJobs, *Stream, WindowSize, bForceOverwrite, bComputeChecksums, OnEntryExtracted, FailedJobIndex))
+			{
+				if (WeakThis.IsValid() && FileJobs.IsValidIndex(FailedJobIndex))
+				{
+					WeakThis->ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Cannot extract '%s' entry to '%s'. Aborting async extracting entries"), *FileJobs[FailedJobIndex].EntryName, *FileJobs[FailedJobIndex].FilePath));
+				}
+
+				ExecuteResult(false);
+				return;
+			}
+
+			UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully extracted '%d' entries with a prefetch window of %lld bytes"), NumOfEntries, WindowSize);
+
+			ExecuteResult(true);
+			return;
+		}
+
+		std::atomic<int32> NextJobIndex{0};
+		std::atomic<bool> bFailed{false};
+
+		ParallelFor(NumOfWorkers, [&](int32 WorkerIndex)
+		{
+			FTarPositionalReader Reader(*Stream, ArchiveMemory);
+
+			if (!Reader.IsValid())
+			{
+				UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar archive for extraction worker %d"), WorkerIndex);
+				bFailed = true;
+				return;
+			}
+
+			// Workers pick the next entry once they are done with the previous one, which balances entries of different sizes
+			for (int32 JobIndex = NextJobIndex++; JobIndex < FileJobs.Num() && !bFailed; JobIndex = NextJobIndex++)
+			{
+				const FTarExtractionJob& Job = FileJobs[JobIndex];
+				uint32 Checksum = 0;
+
+				const bool bSuccess = [&]()
+				{
+					TUniquePtr<IFileHandle> FileHandle = OpenExtractionFile(Job, bForceOverwrite);
+
+					if (!FileHandle.IsValid())
+					{
+						return false;
+					}
+
+					uint32* ChecksumPtr = bComputeChecksums ? &Checksum : nullptr;
+
+					return Job.SparseRegions.Num() > 0
+						       ? Reader.CopySparseTo(Job.DataOffset, Job.RealSize, Job.SparseRegions, *FileHandle, ChecksumPtr)
+						       : Reader.CopyTo(Job.DataOffset, Job.Size, *FileHandle, ChecksumPtr);
+				}();
+
+				if (!bSuccess)
+				{
+					if (WeakThis.IsValid())
+					{
+						WeakThis->ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Cannot extract '%s' entry to '%s'. Aborting async extracting entries"), *Job.EntryName, *Job.FilePath));
+					}
+
+					bFailed = true;
+					return;
+				}
+
+				if (bComputeChecksums)
+				{
+					Encapsulator->SetEntryChecksum(Job.Index, Checksum);
+				}
+
+				ExecuteProgress(static_cast<float>(++NumOfExtractedEntries) / NumOfEntries * 100);
+			}
+		});
+
+		if (bFailed)
+		{
+			ExecuteResult(false);
+			return;
+		}
+
+		UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully extracted '%d' entries using %d workers"), NumOfEntries, NumOfWorkers);
+
+		ExecuteResult(true);
+	});
+}
+
+bool URuntimeArchiverTar::ExtractEntryToMemory(const FRuntimeArchiveEntry& EntryInfo, TArray64<uint8>& UnarchivedData)
+{
+	if (!Super::ExtractEntryToMemory(EntryInfo, UnarchivedData))
+	{
+		return false;
+	}
+
+	int32 NumOfArchiveEntries;
+	if (!GetArchiveEntries(NumOfArchiveEntries) || EntryInfo.Index > (NumOfArchiveEntries - 1))
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Tar entry index %d is invalid. Min index: 0, Max index: %d"), EntryInfo.Index, (NumOfArchiveEntries - 1)));
+		return false;
+	}
+
+	int32 Index;
+
+	// Make sure we have such entry. Hard links are extracted from the entry they point to
+	if (!TarEncapsulator->FindEntryIndex(EntryInfo.Name, Index) || !TarEncapsulator->ResolveHardLink(Index))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to find tar entry '%s' to write into memory"), *EntryInfo.Name));
+		return false;
+	}
+
+	FRuntimeArchiverTarEntryRecord Record;
+	FTarHeader Header;
+
+	// Positioning the stream at the entry header to read the data
+	if (!TarEncapsulator->GetEntryRecord(Index, Record) || !TarEncapsulator->ReadHeaderByIndex(Index, Header, false))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to read header of tar entry '%s' to write into memory"), *EntryInfo.Name));
+		return false;
+	}
+
+	bool bSuccess = true;
+
+	if (Record.SparseRegions.Num() == 0)
+	{
+		UnarchivedData.SetNumUninitialized(Record.Size);
+		bSuccess = TarEncapsulator->ReadData(UnarchivedData);
+	}
+	else
+	{
+		// The holes are left zeroed, only the data regions are read
+		UnarchivedData.SetNumZeroed(Record.RealSize);
+
+		for (const FRuntimeArchiverTarSparseRegion& Region : Record.SparseRegions)
+		{
+			bSuccess = bSuccess && (Region.Size == 0 || TarEncapsulator->ReadData(UnarchivedData.GetData() + Region.Offset, Region.Size));
+		}
+	}
+
+	if (!bSuccess)
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to read data from tar entry '%s' to write into memory"), *EntryInfo.Name));
+		UnarchivedData.Empty();
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully extracted tar entry '%s' into memory"), *EntryInfo.Name);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::RemoveEntry(FString EntryName)
+{
+	int32 EntryIndex;
+
+	if (!FindModifiableEntry(EntryName, TEXT("remove"), EntryIndex))
+	{
+		return false;
+	}
+
+	if (!TarEncapsulator->RemoveEntry(EntryIndex))
+	{
+		ReportError(ERuntimeArchiverErrorCode::RemoveError, FString::Printf(TEXT("Unable to remove tar entry '%s'"), *EntryName));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully removed tar entry '%s'"), *EntryName);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::ReplaceEntry(FString EntryName, TArray<uint8> DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel)
+{
+	return ReplaceEntry(MoveTemp(EntryName), TArray64<uint8>(MoveTemp(DataToBeArchived)), CompressionLevel);
+}
+
+bool URuntimeArchiverTar::ReplaceEntry(FString EntryName, const TArray64<uint8>& DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel)
+{
+	int32 EntryIndex;
+
+	if (!FindModifiableEntry(EntryName, TEXT("replace"), EntryIndex))
+	{
+		return false;
+	}
+
+	FTarHeader Header;
+	FRuntimeArchiveEntry EntryInfo;
+
+	if (!TarEncapsulator->ReadHeaderByIndex(EntryIndex, Header, true) || !FTarHeader::ToEntry(Header, EntryIndex, EntryInfo))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to read tar header with entry name '%s'"), *EntryName));
+		return false;
+	}
+
+	if (EntryInfo.bIsDirectory)
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Unable to replace tar entry '%s' because it is a directory"), *EntryName));
+		return false;
+	}
+
+	uint64 ContentHash = 0;
+
+	// Rewriting the entry in place if the new content fits into the space it occupies, so that nothing else has to be written
+	if (sizeof(FTarHeader) + RuntimeArchiverTarOperations::RoundUp<int64>(DataToBeArchived.Num(), 512) <= TarEncapsulator->GetEntrySpan(EntryIndex) && CanOverwriteEntry(EntryName, DataToBeArchived, ContentHash))
+	{
+		if (!FTarHeader::GenerateHeader(EntryName, DataToBeArchived.Num(), FDateTime::Now(), false, Header))
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate file header for entry '%s'"), *EntryName));
+			return false;
+		}
+
+		if (!TarEncapsulator->OverwriteEntry(EntryIndex, Header, DataToBeArchived.GetData(), DataToBeArchived.Num()))
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to rewrite tar entry '%s' in place"), *EntryName));
+			return false;
+		}
+
+		if (bDeduplicateEntries && DataToBeArchived.Num() > 0)
+		{
+			TarEncapsulator->SetEntryContentHash(EntryIndex, ContentHash);
+		}
+
+		UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully replaced tar entry '%s' in place with %lld bytes"), *EntryName, DataToBeArchived.Num());
+
+		return true;
+	}
+
+	// Otherwise the entry is added to the end of the archive the same way as a new entry, and only then the old entry is removed, leaving a vacated region behind,
+	// so that the entry is not lost if the new one cannot be written. The old entry must not be the one the new entry is deduplicated against
+	FRuntimeArchiverTarEntryRecord OldRecord;
+	int32 NumOfEntries = 0;
+	TarEncapsulator->GetEntryRecord(EntryIndex, OldRecord);
+	TarEncapsulator->GetArchiveEntries(NumOfEntries);
+	TarEncapsulator->ClearEntryContentHash(EntryIndex);
+
+	// The written data may still be buffered, and the write can only be relied on once it is in the archive
+	const bool bIsAdded = AddEntryFromMemory(EntryName, DataToBeArchived, CompressionLevel);
+
+	if (!bIsAdded || !TarEncapsulator->Flush())
+	{
+		// The entries written for the replacement are the last ones, so removing them only moves the write position back
+		for (int32 NumOfWrittenEntries = 0; TarEncapsulator->GetArchiveEntries(NumOfWrittenEntries) && NumOfWrittenEntries > NumOfEntries;)
+		{
+			if (!TarEncapsulator->RemoveEntry(NumOfWrittenEntries - 1))
+			{
+				break;
+			}
+		}
+
+		if (OldRecord.bHasContentHash)
+		{
+			TarEncapsulator->SetEntryContentHash(EntryIndex, OldRecord.ContentHash);
+		}
+
+		if (bIsAdded)
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write the new tar entry '%s' to replace the old one"), *EntryName));
+		}
+
+		return false;
+	}
+
+	// The new entries follow all the existing ones, so the old entry keeps its index, and its name then resolves to the new entry
+	if (!TarEncapsulator->RemoveEntry(EntryIndex))
+	{
+		ReportError(ERuntimeArchiverErrorCode::RemoveError, FString::Printf(TEXT("Unable to remove the old tar entry '%s' after adding the new one to replace it"), *EntryName));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully replaced tar entry '%s' with %lld bytes"), *EntryName, DataToBeArchived.Num());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::AddEntryFromMemoryConcurrently(FString EntryName, const TArray64<uint8>& DataToBeArchived)
+{
+	if (!Super::AddEntryFromMemory(EntryName, DataToBeArchived, ERuntimeArchiverCompressionLevel::Compression6))
+	{
+		return false;
+	}
+
+	FTarHeader Header;
+
+	if (!FTarHeader::GenerateHeader(EntryName, DataToBeArchived.Num(), FDateTime::Now(), false, Header))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate file header for entry '%s'"), *EntryName));
+		return false;
+	}
+
+	int64 DataOffset;
+
+	// The parent directories are reserved under the same lock as the entry, so that concurrent producers do not write the same directory twice
+	{
+		FScopeLock WriteLock(&TarEncapsulator->GetWriteLock());
+
+		if (!WriteParentDirectoryEntries(EntryName))
+		{
+			return false;
+		}
+
+		if (!TarEncapsulator->ReserveEntry(Header, DataOffset))
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to reserve space for entry '%s'"), *EntryName));
+			return false;
+		}
+	}
+
+	if (!TarEncapsulator->WriteReservedData(DataOffset, DataToBeArchived.GetData(), DataToBeArchived.Num()))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write data for entry '%s' from memory"), *EntryName));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully added tar entry '%s' with size %lld bytes from memory concurrently"), *EntryName, DataToBeArchived.Num());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::BeginEntry(FString EntryName)
+{
+	if (!Super::AddEntryFromMemory(EntryName, TArray64<uint8>(), ERuntimeArchiverCompressionLevel::Compression6))
+	{
+		return false;
+	}
+
+	if (TarEncapsulator->IsStreamingEntry())
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to begin entry '%s' because the previous entry has not been ended"), *EntryName));
+		return false;
+	}
+
+	if (!WriteParentDirectoryEntries(EntryName))
+	{
+		return false;
+	}
+
+	FTarHeader Header;
+
+	if (!FTarHeader::GenerateHeader(EntryName, 0, FDateTime::Now(), false, Header))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate file header for entry '%s'"), *EntryName));
+		return false;
+	}
+
+	if (!TarEncapsulator->BeginStreamedEntry(Header))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write placeholder header for entry '%s'"), *EntryName));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully began tar entry '%s'"), *EntryName);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::AppendEntryData(TArray<uint8> Data)
+{
+	return AppendEntryData(Data.GetData(), Data.Num());
+}
+
+bool URuntimeArchiverTar::AppendEntryData(const void* Data, int64 Size)
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (!TarEncapsulator->IsStreamingEntry())
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, TEXT("Unable to append entry data because no entry has been begun"));
+		return false;
+	}
+
+	if (!TarEncapsulator->AppendStreamedEntryData(Data, Size))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to append %lld bytes of entry data"), Size));
+		return false;
+	}
+
+	return true;
+}
+
+bool URuntimeArchiverTar::EndEntry()
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (!TarEncapsulator->IsStreamingEntry())
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, TEXT("Unable to end entry because no entry has been begun"));
+		return false;
+	}
+
+	if (!TarEncapsulator->EndStreamedEntry())
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, TEXT("Unable to patch the header of the streamed entry"));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully ended streamed tar entry"));
+
+	return true;
+}
+
+bool URuntimeArchiverTar::Compact(int64 MaxBytesToMove, bool& bIsCompacted)
+{
+	bIsCompacted = false;
+
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (Mode != ERuntimeArchiverMode::Write)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Only '%s' mode is supported for compacting the archive (using mode: '%s')"), *UEnum::GetValueAsName(ERuntimeArchiverMode::Write).ToString(), *UEnum::GetValueAsName(Mode).ToString()));
+		return false;
+	}
+
+	// Moving the entries would move them across the volume boundaries, and the volumes cannot be shrunk
+	if (TarEncapsulator->IsMultiVolume())
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, TEXT("Compacting multi-volume tar archives is not supported"));
+		return false;
+	}
+
+	if (!TarEncapsulator->Compact(MaxBytesToMove, bIsCompacted))
+	{
+		ReportError(ERuntimeArchiverErrorCode::RemoveError, TEXT("Unable to compact tar archive"));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully compacted tar archive '%s'. Fully compacted: %s"), *GetName(), bIsCompacted ? TEXT("true") : TEXT("false"));
+
+	return true;
+}
+
+bool URuntimeArchiverTar::FinalizeArchive()
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (Mode != ERuntimeArchiverMode::Write)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Only '%s' mode is supported for finalizing the archive (using mode: '%s')"), *UEnum::GetValueAsName(ERuntimeArchiverMode::Write).ToString(), *UEnum::GetValueAsName(Mode).ToString()));
+		return false;
+	}
+
+	if (!TarEncapsulator->Finalize())
+	{
+		ReportError(ERuntimeArchiverErrorCode::CloseError, TEXT("Unable to finalize tar archive"));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully finalized tar archive '%s'"), *GetName());
+
+	return true;
+}
+
+TUniquePtr<FRuntimeArchiverTarEntryReader> URuntimeArchiverTar::OpenEntryReader(const FRuntimeArchiveEntry& EntryInfo)
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return nullptr;
+	}
+
+	if (Mode != ERuntimeArchiverMode::Read)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Only '%s' mode is supported for reading the entry (using mode: '%s')"), *UEnum::GetValueAsName(ERuntimeArchiverMode::Read).ToString(), *UEnum::GetValueAsName(Mode).ToString()));
+		return nullptr;
+	}
+
+	int32 Index;
+
+	// Hard links are read from the entry they point to
+	if (!TarEncapsulator->FindEntryIndex(EntryInfo.Name, Index) || !TarEncapsulator->ResolveHardLink(Index))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to find tar entry '%s' to read"), *EntryInfo.Name));
+		return nullptr;
+	}
+
+	FRuntimeArchiverTarEntryRecord Record;
+	FTarHeader Header;
+
+	// Positioning the stream at the entry header so that the reader continues from there
+	if (!TarEncapsulator->GetEntryRecord(Index, Record) || !TarEncapsulator->ReadHeaderByIndex(Index, Header, false))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to read header of tar entry '%s' to read"), *EntryInfo.Name));
+		return nullptr;
+	}
+
+	return MakeUnique<FRuntimeArchiverTarEntryReader>(this, Record.RealSize, MoveTemp(Record.SparseRegions));
+}
+
+bool URuntimeArchiverTar::GetEntryDataView(const FRuntimeArchiveEntry& EntryInfo, TArrayView64<const uint8>& EntryData)
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (Mode != ERuntimeArchiverMode::Read)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Only '%s' mode is supported for getting the entry data view (using mode: '%s')"), *UEnum::GetValueAsName(ERuntimeArchiverMode::Read).ToString(), *UEnum::GetValueAsName(Mode).ToString()));
+		return false;
+	}
+
+	const TArrayView64<const uint8> ArchiveMemory = TarEncapsulator->GetArchiveMemory();
+
+	if (ArchiveMemory.Num() == 0)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedLocation, TEXT("Entry data views are only available for archives opened in memory or memory-mapped from storage"));
+		return false;
+	}
+
+	int32 Index;
+
+	// Hard links are viewed in the entry they point to
+	if (!TarEncapsulator->FindEntryIndex(EntryInfo.Name, Index) || !TarEncapsulator->ResolveHardLink(Index))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to find tar entry '%s' to get the data view"), *EntryInfo.Name));
+		return false;
+	}
+
+	FRuntimeArchiverTarEntryRecord Record;
+
+	if (!TarEncapsulator->GetEntryRecord(Index, Record))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to get record of tar entry '%s' to get the data view"), *EntryInfo.Name));
+		return false;
+	}
+
+	// The holes of sparse entries are not stored, so their content is not contiguous in the archive
+	if (Record.SparseRegions.Num() > 0)
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Unable to get the data view of sparse tar entry '%s'"), *EntryInfo.Name));
+		return false;
+	}
+
+	if (Record.DataOffset + Record.Size > ArchiveMemory.Num())
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Data of tar entry '%s' exceeds the archive size"), *EntryInfo.Name));
+		return false;
+	}
+
+	EntryData = ArchiveMemory.Mid(Record.DataOffset, Record.Size);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::GetArchiveChecksum(int64& Checksum)
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (!TarEncapsulator->IsComputingChecksums())
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get tar archive checksum because the checksums are not computed. Enable bComputeChecksums before creating or opening the archive"));
+		return false;
+	}
+
+	if (Mode == ERuntimeArchiverMode::Write && !TarEncapsulator->IsFinalized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get tar archive checksum because the archive is still being written. Finalize it with FinalizeArchive first"));
+		return false;
+	}
+
+	uint32 ArchiveChecksum;
+
+	if (!TarEncapsulator->GetArchiveChecksum(ArchiveChecksum))
+	{
+		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get tar archive checksum"));
+		return false;
+	}
+
+	Checksum = ArchiveChecksum;
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar archive checksum %08x"), ArchiveChecksum);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::ExtractFileEntryToStorage(const FRuntimeArchiveEntry& EntryInfo, const FString& FilePath)
+{
+	TUniquePtr<FRuntimeArchiverTarEntryReader> EntryReader = OpenEntryReader(EntryInfo);
+
+	if (!EntryReader.IsValid())
+	{
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// Ensure we have a valid directory to extract entry to
+	{
+		const FString DirectoryPath = FPaths::GetPath(FilePath);
+		if (!DirectoryPath.IsEmpty() && !PlatformFile.CreateDirectoryTree(*DirectoryPath))
+		{
+			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to create subdirectory '%s' to extract entry '%s'"), *DirectoryPath, *EntryInfo.Name));
+			return false;
+		}
+	}
+
+	TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenWrite(*FilePath));
+
+	if (!FileHandle.IsValid())
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to open file '%s' to extract entry '%s'"), *FilePath, *EntryInfo.Name));
+		return false;
+	}
+
+	// The entry data is copied through a bounded buffer, so the memory usage does not depend on the entry size
+	TArray64<uint8> Buffer;
+	Buffer.SetNumUninitialized(FMath::Min<int64>(EntryReader->GetSize(), StreamingChunkSize));
+
+	bool bEndsWithHole = false;
+
+	while (!EntryReader->IsFinished())
+	{
+		// The holes of sparse entries are skipped by seeking, so that no zeros are written for them
+		if (const int64 HoleSize = EntryReader->SkipHole())
+		{
+			if (!FileHandle->Seek(FileHandle->Tell() + HoleSize))
+			{
+				ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to skip a hole of tar entry '%s' in file '%s'"), *EntryInfo.Name, *FilePath));
+				return false;
+			}
+
+			bEndsWithHole = true;
+			continue;
+		}
+
+		bEndsWithHole = false;
+		int64 BytesRead;
+
+		if (!EntryReader->Read(Buffer.GetData(), Buffer.Num(), BytesRead))
+		{
+			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to read data from tar entry '%s' to write into file '%s'"), *EntryInfo.Name, *FilePath));
+			return false;
+		}
+
+		if (!FileHandle->Write(Buffer.GetData(), BytesRead))
+		{
+			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to write data of tar entry '%s' to file '%s'"), *EntryInfo.Name, *FilePath));
+			return false;
+		}
+	}
+
+	// Seeking alone does not extend the file, so a trailing hole is completed by writing its last byte
+	if (bEndsWithHole)
+	{
+		const uint8 NullByte = 0;
+
+		if (!FileHandle->Seek(EntryReader->GetSize() - 1) || !FileHandle->Write(&NullByte, 1))
+		{
+			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to write the end of tar entry '%s' to file '%s'"), *EntryInfo.Name, *FilePath));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool URuntimeArchiverTar::Initialize()
+{
+	if (!Super::Initialize())
+	{
+		return false;
+	}
+
+	TarEncapsulator = MakeShared<FRuntimeArchiverTarEncapsulator, ESPMode::ThreadSafe>(WriteBufferSize, FileBufferSize, bUseIndexFile, bMemoryMapArchive, NumOfAsyncReadRequests, AsyncReadRequestSize, bComputeChecksums);
+
+	if (!TarEncapsulator.IsValid())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Unable to allocate memory for tar archiver"));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully initialized tar archiver '%s'"), *GetName());
+
+	return true;
+}
+
+bool URuntimeArchiverTar::IsInitialized() const
+{
+	return Super::IsInitialized() && TarEncapsulator.IsValid() && TarEncapsulator->IsValid();
+}
+
+void URuntimeArchiverTar::Reset()
+{
+	TarEncapsulator.Reset();
+
+	Super::Reset();
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully uninitialized tar archiver '%s'"), *GetName());
+}
+
+bool URuntimeArchiverTar::WriteParentDirectoryEntries(const FString& EntryName)
+{
+	// Parsing directories from entry name
+	TArray<FString> Directories = URuntimeArchiverUtilities::ParseDirectories(EntryName);
+
+	for (const FString& Directory : Directories)
+	{
+		// Skip if the archive already contains this directory entry
+		if (TarEncapsulator->ContainsEntry(Directory))
+		{
+			continue;
+		}
+
+		FTarHeader Header;
+
+		if (!FTarHeader::GenerateHeader(Directory, 0, FDateTime::Now(), true, Header))
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate directory header for entry '%s'"), *Directory));
+			return false;
+		}
+
+		// Directories only require writing a header, no data
+		if (!TarEncapsulator->WriteHeader(Header))
+		{
+			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write header for directory entry '%s'"), *Directory));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool URuntimeArchiverTar::WriteFileHeader(const FString& EntryName, int64 Size, const TArray<FRuntimeArchiverTarSparseRegion>& SparseRegions)
+{
+	FTarHeader Header;
+	TArray<FTarSparseHeader> ExtensionHeaders;
+
+	const bool bIsHeaderGenerated = SparseRegions.Num() > 0
+		                                ? FTarHeader::GenerateSparseHeader(EntryName, Size, SparseRegions, FDateTime::Now(), Header, ExtensionHeaders)
+		                                : FTarHeader::GenerateHeader(EntryName, Size, FDateTime::Now(), false, Header);
+
+	if (!bIsHeaderGenerated)
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate file header for entry '%s'"), *EntryName));
+		return false;
+	}
+
+	if (!TarEncapsulator->WriteHeader(Header, ExtensionHeaders, SparseRegions))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write header for entry '%s'"), *EntryName));
+		return false;
+	}
+
+	return true;
+}
+
+bool URuntimeArchiverTar::FindDuplicateEntry(uint64 ContentHash, int64 Size, TFunctionRef<bool(int64 Offset, uint8* Data, int64 ChunkSize)> ReadContent, FString& TargetName)
+{
+	TArray<int32> CandidateIndices;
+	TarEncapsulator->FindEntriesByContentHash(ContentHash, CandidateIndices);
+
+	if (CandidateIndices.Num() == 0)
+	{
+		return false;
+	}
+
+	TArray64<uint8> ContentBuffer;
+	TArray64<uint8> ArchivedBuffer;
+	ContentBuffer.SetNumUninitialized(FMath::Min<int64>(Size, StreamingChunkSize));
+	ArchivedBuffer.SetNumUninitialized(ContentBuffer.Num());
+
+	for (const int32 CandidateIndex : CandidateIndices)
+	{
+		FRuntimeArchiverTarEntryRecord Record;
+
+		if (!TarEncapsulator->GetEntryRecord(CandidateIndex, Record) || Record.RealSize != Size)
+		{
+			continue;
+		}
+
+		// The link refers to the target by name, which resolves to the first entry with it, so an entry hidden behind an earlier one of the same name cannot be linked to
+		int32 NamedIndex;
+		if (!TarEncapsulator->FindEntryIndex(Record.Name, NamedIndex) || NamedIndex != CandidateIndex)
+		{
+			continue;
+		}
+
+		// Hash collisions are ruled out by comparing the content with the archived one
+		bool bIsEqual = true;
+
+		for (int64 Offset = 0; bIsEqual && Offset < Size; Offset += ContentBuffer.Num())
+		{
+			const int64 ChunkSize = FMath::Min<int64>(Size - Offset, ContentBuffer.Num());
+
+			if (!ReadContent(Offset, ContentBuffer.GetData(), ChunkSize) || !TarEncapsulator->ReadEntryContent(CandidateIndex, Offset, ArchivedBuffer.GetData(), ChunkSize))
+			{
+				UE_LOG(LogRuntimeArchiver, Warning, TEXT("Unable to compare content with tar entry '%s'. The content is stored without deduplication"), *Record.Name);
+				return false;
+			}
+
+			bIsEqual = FMemory::Memcmp(ContentBuffer.GetData(), ArchivedBuffer.GetData(), ChunkSize) == 0;
+		}
+
+		if (bIsEqual)
+		{
+			TargetName = MoveTemp(Record.Name);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool URuntimeArchiverTar::WriteHardLinkEntry(const FString& EntryName, const FString& TargetName)
+{
+	FTarHeader Header;
+
+	if (!FTarHeader::GenerateHardLinkHeader(EntryName, TargetName, FDateTime::Now(), Header))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate hard link header for entry '%s' pointing to '%s'"), *EntryName, *TargetName));
+		return false;
+	}
+
+	// Links have no data, only the header is written
+	if (!TarEncapsulator->WriteHeader(Header))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write header for hard link entry '%s'"), *EntryName));
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully added tar entry '%s' as a hard link to the identical entry '%s'"), *EntryName, *TargetName);
+
+	return true;
+}
+
+bool URuntimeArchiverTar::FindModifiableEntry(const FString& EntryName, const TCHAR* OperationName, int32& EntryIndex)
+{
+	if (!IsInitialized())
+	{
+		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Archiver is not initialized"));
+		return false;
+	}
+
+	if (Mode != ERuntimeArchiverMode::Write)
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Only '%s' mode is supported to %s entries (using mode: '%s')"), *UEnum::GetValueAsName(ERuntimeArchiverMode::Write).ToString(), OperationName, *UEnum::GetValueAsName(Mode).ToString()));
+		return false;
+	}
+
+	// The vacated regions would straddle the volume boundaries, and the volumes cannot be shrunk
+	if (TarEncapsulator->IsMultiVolume())
+	{
+		ReportError(ERuntimeArchiverErrorCode::UnsupportedMode, FString::Printf(TEXT("Unable to %s tar entry '%s' because modifying entries of multi-volume tar archives is not supported"), OperationName, *EntryName));
+		return false;
+	}
+
+	if (!TarEncapsulator->FindEntryIndex(EntryName, EntryIndex))
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Unable to find the entry index under the entry name '%s'"), *EntryName));
+		return false;
+	}
+
+	// The links would be left pointing to an entry that no longer exists or follows them
+	if (TarEncapsulator->IsHardLinkTarget(EntryIndex))
+	{
+		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Unable to %s tar entry '%s' because hard links point to it"), OperationName, *EntryName));
+		return false;
+	}
+
+	return true;
+}
+
+bool URuntimeArchiverTar::CanOverwriteEntry(const FString& EntryName, const TArray64<uint8>& Data, uint64& ContentHash)
+{
+	if (SparseThreshold > 0 && !TarEncapsulator->IsMultiVolume())
+	{
+		TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+		FTarSparseMapBuilder SparseMapBuilder(SparseThreshold);
+		SparseMapBuilder.Append(Data.GetData(), Data.Num());
+		SparseMapBuilder.Finish(SparseRegions);
+
+		if (SparseRegions.Num() > 0)
+		{
+			return false;
+		}
+	}
+
+	if (!bDeduplicateEntries || Data.Num() == 0)
+	{
+		return true;
+	}
+
+	ContentHash = HashContent(0, Data.GetData(), Data.Num());
+
+	FString TargetName;
+
+	const bool bIsDuplicate = FindDuplicateEntry(ContentHash, Data.Num(), [&Data](int64 Offset, uint8* ChunkData, int64 ChunkSize)
+	{
+		FMemory::Memcpy(ChunkData, Data.GetData() + Offset, ChunkSize);
+		return true;
+	}, TargetName);
+
+	// The entry already holding the same content is simply rewritten
+	return !bIsDuplicate || TargetName.Equals(EntryName, ESearchCase::CaseSensitive);
+}
+
+void URuntimeArchiverTar::ReportError(ERuntimeArchiverErrorCode ErrorCode, const FString& ErrorString) const
+{
+	Super::ReportError(ErrorCode, ErrorString);
+}
+
+FRuntimeArchiverTarEncapsulator::FRuntimeArchiverTarEncapsulator(int64 InWriteBufferSize, int64 InFileBufferSize, bool bInUseIndexFile, bool bInMemoryMapArchive, int32 InNumOfAsyncReadRequests, int64 InAsyncReadRequestSize, bool bInComputeChecksums)
+	: VolumeStream{nullptr}
+  , SegmentedMemoryStream{nullptr}
+  , HashingStream{nullptr}
+  , RemainingDataSize{0}
+  , StreamedEntrySize{0}
+  , LastHeaderPosition{0}
+  , CurrentEntryChecksum{0}
+  , bHasDuplicateNames{false}
+  , WriteBufferCapacity{RuntimeArchiverTarOperations::RoundUp<int64>(FMath::Max<int64>(InWriteBufferSize, 0), sizeof(FTarHeader))}
+  , FileBufferSize{FMath::Max<int64>(InFileBufferSize, 0)}
+  , bIsFinalized{false}
+  , bHasStaleTail{false}
+  , bHasDamagedEntry{false}
+  , bIsIndexFileInvalidated{false}
+  , bUseIndexFile{bInUseIndexFile}
+  , bMemoryMapArchive{bInMemoryMapArchive}
+  , NumOfAsyncReadRequests{FMath::Max<int32>(InNumOfAsyncReadRequests, 0)}
+  , AsyncReadRequestSize{FMath::Max<int64>(InAsyncReadRequestSize, 1)}
+  , bComputeChecksums{bInComputeChecksums}
+{
+}
+
+FRuntimeArchiverTarEncapsulator::~FRuntimeArchiverTarEncapsulator()
+{
+	if (Stream.IsValid())
+	{
+		if (Stream->IsWrite() && !Finalize())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to finalize tar archive while closing it. The archive is incomplete"));
+		}
+
+		Stream.Reset();
+	}
+}
+
+bool FRuntimeArchiverTarEncapsulator::IsValid()
+{
+	return Stream.IsValid() && Stream->IsValid();
+}
+
+bool FRuntimeArchiverTarEncapsulator::TestArchive()
+{
+	if (Stream->IsWrite())
+	{
+		return true;
+	}
+
+	static FTarHeader Header{};
+
+	if (!Rewind())
+	{
+		return false;
+	}
+
+	return ReadHeader(Header);
+}
+
+bool FRuntimeArchiverTarEncapsulator::OpenFile(const FString& ArchivePath, bool bWrite)
+{
+	if (Stream.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		return false;
+	}
+
+	if (!bWrite && bMemoryMapArchive)
+	{
+		FRuntimeArchiverMappedFileStream* MappedStream = new FRuntimeArchiverMappedFileStream(ArchivePath, FileBufferSize);
+		ArchiveMemory = MappedStream->GetMappedData();
+		SetStream(TUniquePtr<FRuntimeArchiverBaseStream>(MappedStream));
+	}
+	else if (!bWrite && NumOfAsyncReadRequests > 0)
+	{
+		SetStream(MakeUnique<FRuntimeArchiverAsyncFileStream>(ArchivePath, NumOfAsyncReadRequests, AsyncReadRequestSize));
+	}
+	else
+	{
+		SetStream(MakeUnique<FRuntimeArchiverFileStream>(ArchivePath, bWrite, false, FileBufferSize));
+	}
+	ArchiveFilePath = ArchivePath;
+
+	if (!Stream->IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		return false;
+	}
+
+	if (!TestArchive())
+	{
+		return false;
+	}
+
+	return bWrite || BuildEntryIndex();
+}
+
+bool FRuntimeArchiverTarEncapsulator::OpenMemory(const TArray64<uint8>& ArchiveData, int32 InitialAllocationSize, bool bWrite)
+{
+	if (!bWrite)
+	{
+		return OpenMemory(MakeUnique<FRuntimeArchiverMemoryStream>(ArchiveData));
+	}
+
+	if (Stream.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		return false;
+	}
+
+	// Archives created in memory grow by segments, so that the data written before is never reallocated
+	SegmentedMemoryStream = new FRuntimeArchiverSegmentedMemoryStream(InitialAllocationSize);
+	SetStream(TUniquePtr<FRuntimeArchiverBaseStream>(SegmentedMemoryStream));
+
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		return false;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::OpenMemory(TUniquePtr<FRuntimeArchiverMemoryStream> MemoryStream)
+{
+	if (Stream.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		return false;
+	}
+
+	const bool bWrite = MemoryStream->IsWrite();
+	if (!bWrite)
+	{
+		ArchiveMemory = MemoryStream->GetArchiveData();
+	}
+	SetStream(MoveTemp(MemoryStream));
+
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		return false;
+	}
+
+	if (!TestArchive())
+	{
+		return false;
+	}
+
+	return bWrite || BuildEntryIndex();
+}
+
+bool FRuntimeArchiverTarEncapsulator::OpenVolumes(const TArray<FString>& VolumePaths)
+{
+	if (Stream.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		return false;
+	}
+
+	VolumeStream = new FRuntimeArchiverVolumeStream(VolumePaths);
+	SetStream(TUniquePtr<FRuntimeArchiverBaseStream>(VolumeStream));
+
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		return false;
+	}
+
+	if (!TestArchive())
+	{
+		return false;
+	}
+
+	return BuildEntryIndex();
+}
+
+bool FRuntimeArchiverTarEncapsulator::CreateVolumes(const FString& ArchivePath, int64 MaxVolumeSize)
+{
+	if (Stream.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		return false;
+	}
+
+	VolumeStream = new FRuntimeArchiverVolumeStream(ArchivePath, MaxVolumeSize);
+	SetStream(TUniquePtr<FRuntimeArchiverBaseStream>(VolumeStream));
+
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		return false;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::OpenFileToAppend(const FString& ArchivePath)
+{
+	if (Stream.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		return false;
+	}
+
+	SetStream(MakeUnique<FRuntimeArchiverFileStream>(ArchivePath, true, true, FileBufferSize));
+	ArchiveFilePath = ArchivePath;
+
+	if (!Stream->IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		return false;
+	}
+
+	// Pre-seeding the index with the existing entries so that the directory entries are not duplicated
+	int64 EndOfEntriesOffset;
+	bool bIsDamaged;
+	if (!BuildEntryIndex(EndOfEntriesOffset, bIsDamaged))
+	{
+		return false;
+	}
+
+	if (bIsDamaged)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to append to tar archive '%s' because it is damaged after entry %d"), *ArchivePath, EntryRecords.Num());
+		return false;
+	}
+
+	if (EndOfEntriesOffset > Stream->Size())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to append to tar archive '%s' because its last entry is truncated"), *ArchivePath);
+		return false;
+	}
+
+	// New entries overwrite the end-of-archive marker, which is written again on finalization
+	if (!Stream->Seek(EndOfEntriesOffset))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to seek to the end of the entries at offset %lld to append"), EndOfEntriesOffset);
+		return false;
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Appending to tar archive '%s' after %d existing entries at offset %lld"), *ArchivePath, EntryRecords.Num(), EndOfEntriesOffset);
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::BuildEntryIndex()
+{
+	int64 EndOfEntriesOffset;
+	bool bIsDamaged;
+	return BuildEntryIndex(EndOfEntriesOffset, bIsDamaged);
+}
+
+bool FRuntimeArchiverTarEncapsulator::BuildEntryIndex(int64& EndOfEntriesOffset, bool& bIsDamaged)
+{
+	bIsDamaged = false;
+
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to build tar entry index because stream is invalid"));
+		return false;
+	}
+
+	EntryRecords.Reset();
+	EntryHeaderOffsetsByName.Reset();
+	EntryHeaderOffsetsByContentHash.Reset();
+	NumOfHardLinksByTargetName.Reset();
+	bHasDuplicateNames = false;
+
+	// Making sure looking from the start
+	if (!Rewind())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to rewind read/write position of tar archive to build the entry index"));
+		return false;
+	}
+
+	// The index file replaces reading the headers spread across the whole archive
+	if (bUseIndexFile && !ArchiveFilePath.IsEmpty() && LoadIndexFile())
+	{
+		EndOfEntriesOffset = GetEndOfEntriesOffset();
+		return Rewind();
+	}
+
+	FRuntimeArchiverTarScanner Scanner(*Stream);
+	FTarHeader Header;
+
+	// Iterate all headers once, jumping directly over the entry data
+	while (Scanner.Next(Header))
+	{
+		FRuntimeArchiverTarEntryRecord Record;
+		Record.Name = StringCast<TCHAR>(Header.GetName()).Get();
+		Record.HeaderOffset = Scanner.GetHeaderOffset();
+		Record.DataOffset = Scanner.GetDataOffset();
+		Record.Size = Scanner.GetRemainingDataSize();
+		Record.RealSize = Scanner.GetRealSize();
+		Record.SparseRegions = Scanner.GetSparseRegions();
+
+		if (Header.IsHardLink())
+		{
+			Record.LinkName = Header.GetLinkTargetName();
+		}
+
+		AddEntryRecord(MoveTemp(Record));
+	}
+
+	bIsDamaged = Scanner.HasError();
+
+	if (bIsDamaged)
+	{
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Tar archive is damaged after entry %d. Only the preceding entries are indexed"), EntryRecords.Num());
+	}
+
+	EndOfEntriesOffset = GetEndOfEntriesOffset();
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Built tar entry index with %d entries"), EntryRecords.Num());
+
+	return Rewind();
+}
+
+bool FRuntimeArchiverTarEncapsulator::FindEntryIndex(const FString& EntryName, int32& Index) const
+{
+	const int64* HeaderOffset = EntryHeaderOffsetsByName.Find(EntryName);
+
+	if (!HeaderOffset)
+	{
+		return false;
+	}
+
+	Index = FindEntryIndexByHeaderOffset(*HeaderOffset);
+	return Index != INDEX_NONE;
+}
+
+bool FRuntimeArchiverTarEncapsulator::ContainsEntry(const FString& EntryName) const
+{
+	return EntryHeaderOffsetsByName.Contains(EntryName);
+}
+
+bool FRuntimeArchiverTarEncapsulator::GetEntryRecord(int32 Index, FRuntimeArchiverTarEntryRecord& Record) const
+{
+	if (!EntryRecords.IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	Record = EntryRecords[Index];
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::ResolveHardLink(int32& Index) const
+{
+	// Links may only point to preceding entries, which rules out cycles
+	while (EntryRecords.IsValidIndex(Index) && !EntryRecords[Index].LinkName.IsEmpty())
+	{
+		int32 TargetIndex;
+
+		if (!FindEntryIndex(EntryRecords[Index].LinkName, TargetIndex) || TargetIndex >= Index)
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to find tar entry '%s' that hard link '%s' points to"), *EntryRecords[Index].LinkName, *EntryRecords[Index].Name);
+			return false;
+		}
+
+		Index = TargetIndex;
+	}
+
+	return EntryRecords.IsValidIndex(Index);
+}
+
+void FRuntimeArchiverTarEncapsulator::AddContentHash(uint64 ContentHash)
+{
+	SetEntryContentHash(EntryRecords.Num() - 1, ContentHash);
+}
+
+void FRuntimeArchiverTarEncapsulator::SetEntryContentHash(int32 Index, uint64 ContentHash)
+{
+	if (!EntryRecords.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+
+	if (Record.bHasContentHash)
+	{
+		if (TArray<int64>* HeaderOffsets = EntryHeaderOffsetsByContentHash.Find(Record.ContentHash))
+		{
+			HeaderOffsets->Remove(Record.HeaderOffset);
+		}
+	}
+
+	Record.ContentHash = ContentHash;
+	Record.bHasContentHash = true;
+	EntryHeaderOffsetsByContentHash.FindOrAdd(ContentHash).Add(Record.HeaderOffset);
+}
+
+void FRuntimeArchiverTarEncapsulator::ClearEntryContentHash(int32 Index)
+{
+	if (!EntryRecords.IsValidIndex(Index) || !EntryRecords[Index].bHasContentHash)
+	{
+		return;
+	}
+
+	FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+
+	if (TArray<int64>* HeaderOffsets = EntryHeaderOffsetsByContentHash.Find(Record.ContentHash))
+	{
+		HeaderOffsets->Remove(Record.HeaderOffset);
+	}
+
+	Record.ContentHash = 0;
+	Record.bHasContentHash = false;
+}
+
+void FRuntimeArchiverTarEncapsulator::FindEntriesByContentHash(uint64 ContentHash, TArray<int32>& Indices) const
+{
+	Indices.Reset();
+
+	if (const TArray<int64>* HeaderOffsets = EntryHeaderOffsetsByContentHash.Find(ContentHash))
+	{
+		for (const int64 HeaderOffset : *HeaderOffsets)
+		{
+			const int32 Index = FindEntryIndexByHeaderOffset(HeaderOffset);
+
+			if (Index != INDEX_NONE)
+			{
+				Indices.Add(Index);
+			}
+		}
+	}
+}
+
+bool FRuntimeArchiverTarEncapsulator::ReadEntryContent(int32 Index, int64 ContentOffset, uint8* Data, int64 Size)
+{
+	if (!EntryRecords.IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	const FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+
+	if (ContentOffset < 0 || ContentOffset + Size > Record.RealSize)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read %lld bytes at offset %lld of tar entry '%s' with size %lld"), Size, ContentOffset, *Record.Name, Record.RealSize);
+		return false;
+	}
+
+	if (Record.SparseRegions.Num() == 0)
+	{
+		return ReadRawData(Record.DataOffset + ContentOffset, Data, Size);
+	}
+
+	// Only the parts of the regions that overlap the requested range are read, the rest are holes
+	FMemory::Memzero(Data, Size);
+
+	int64 StoredOffset = Record.DataOffset;
+
+	for (const FRuntimeArchiverTarSparseRegion& Region : Record.SparseRegions)
+	{
+		const int64 OverlapStart = FMath::Max<int64>(Region.Offset, ContentOffset);
+		const int64 OverlapEnd = FMath::Min<int64>(Region.Offset + Region.Size, ContentOffset + Size);
+
+		if (OverlapStart < OverlapEnd && !ReadRawData(StoredOffset + OverlapStart - Region.Offset, Data + OverlapStart - ContentOffset, OverlapEnd - OverlapStart))
+		{
+			return false;
+		}
+
+		StoredOffset += Region.Size;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::IsHardLinkTarget(int32 Index) const
+{
+	if (!EntryRecords.IsValidIndex(Index) || !NumOfHardLinksByTargetName.Contains(EntryRecords[Index].Name))
+	{
+		return false;
+	}
+
+	// The links point to the first entry with the name they refer to
+	int32 TargetIndex;
+	return FindEntryIndex(EntryRecords[Index].Name, TargetIndex) && TargetIndex == Index;
+}
+
+int64 FRuntimeArchiverTarEncapsulator::GetEntrySpan(int32 Index) const
+{
+	return EntryRecords.IsValidIndex(Index) ? GetEntryEnd(Index) - EntryRecords[Index].HeaderOffset : 0;
+}
+
+bool FRuntimeArchiverTarEncapsulator::RemoveEntry(int32 Index)
+{
+	if (!IsValid() || !Stream->IsWrite() || IsMultiVolume())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to remove tar entry because stream is invalid, read-only or split into volumes"));
+		return false;
+	}
+
+	if (!EntryRecords.IsValidIndex(Index) || RemainingDataSize != 0 || StreamedEntryHeader.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to remove tar entry at index %d. Number of entries: %d, remaining data size of the entry being written: %lld, streaming an entry: %s"), Index, EntryRecords.Num(), RemainingDataSize, StreamedEntryHeader.IsValid() ? TEXT("true") : TEXT("false"));
+		return false;
+	}
+
+	if (!FlushWriteBuffer())
+	{
+		return false;
+	}
+
+	InvalidateIndexFile();
+	RemoveEntryRecord(Index);
+
+	// The vacated region spans from the end of the preceding entry, which also absorbs the adjacent vacated regions
+	const int64 RegionStart = Index > 0 ? GetEntryEnd(Index - 1) : 0;
+
+	// Nothing follows the last entry, so the next entries and the end-of-archive marker are written over it
+	if (Index == EntryRecords.Num())
+	{
+		bHasStaleTail = true;
+		return Stream->Seek(RegionStart);
+	}
+
+	return VacateRegion(RegionStart, EntryRecords[Index].HeaderOffset - RegionStart);
+}
+
+bool FRuntimeArchiverTarEncapsulator::Flush()
+{
+	if (!IsValid() || !Stream->IsWrite())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to flush tar archive because stream is invalid or read-only"));
+		return false;
+	}
+
+	return FlushWriteBuffer() && Stream->Flush();
+}
+
+bool FRuntimeArchiverTarEncapsulator::OverwriteEntry(int32 Index, const FTarHeader& Header, const void* Data, int64 Size)
+{
+	if (!IsValid() || !Stream->IsWrite() || IsMultiVolume())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to overwrite tar entry because stream is invalid, read-only or split into volumes"));
+		return false;
+	}
+
+	const int64 EntrySpan = GetEntrySpan(Index);
+	const int64 NewEntrySpan = sizeof(FTarHeader) + RuntimeArchiverTarOperations::RoundUp<int64>(Size, 512);
+
+	if (!EntryRecords.IsValidIndex(Index) || RemainingDataSize != 0 || StreamedEntryHeader.IsValid() || NewEntrySpan > EntrySpan)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to overwrite tar entry at index %d occupying %lld bytes with an entry occupying %lld bytes"), Index, EntrySpan, NewEntrySpan);
+		return false;
+	}
+
+	FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+
+	static const uint8 NullBlock[512]{};
+	const int64 PaddingSize = NewEntrySpan - sizeof(FTarHeader) - Size;
+
+	InvalidateIndexFile();
+
+	if (!WriteRawData(Record.HeaderOffset, &Header, sizeof(Header))
+		|| !WriteRawData(Record.HeaderOffset + sizeof(FTarHeader), Data, Size)
+		|| !WriteRawData(Record.HeaderOffset + sizeof(FTarHeader) + Size, NullBlock, PaddingSize))
+	{
+		return false;
+	}
+
+	// The rest of the old entry is vacated
+	if (NewEntrySpan < EntrySpan && !VacateRegion(Record.HeaderOffset + NewEntrySpan, EntrySpan - NewEntrySpan))
+	{
+		return false;
+	}
+
+	Record.DataOffset = Record.HeaderOffset + sizeof(FTarHeader);
+	Record.Size = Size;
+	Record.RealSize = Header.GetRealSize();
+	Record.SparseRegions.Reset();
+	Record.Checksum = bComputeChecksums ? FRuntimeArchiverHashingStream::UpdateChecksum(0, Data, Size) : -1;
+
+	// The content no longer matches the hash it was registered with and no longer comes from the link target
+	ForgetEntryContent(Record);
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::Compact(int64 MaxBytesToMove, bool& bIsCompacted)
+{
+	bIsCompacted = false;
+
+	if (!IsValid() || !Stream->IsWrite() || IsMultiVolume())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to compact tar archive because stream is invalid, read-only or split into volumes"));
+		return false;
+	}
+
+	if (RemainingDataSize != 0 || StreamedEntryHeader.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to compact tar archive while an entry is being written. Remaining data size: %lld, streaming an entry: %s"), RemainingDataSize, StreamedEntryHeader.IsValid() ? TEXT("true") : TEXT("false"));
+		return false;
+	}
+
+	if (!FlushWriteBuffer())
+	{
+		return false;
+	}
+
+	int64 MovedBytes = 0;
+	int64 PackedEnd = 0;
+	int32 Index = 0;
+
+	for (; Index < EntryRecords.Num(); ++Index)
+	{
+		FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+
+		const int64 EntrySpan = GetEntrySpan(Index);
+		const int64 VacatedSize = Record.HeaderOffset - PackedEnd;
+
+		// The entries up to the first vacated region stay where they are
+		if (VacatedSize > 0)
+		{
+			if (MaxBytesToMove > 0 && MovedBytes >= MaxBytesToMove)
+			{
+				break;
+			}
+
+			InvalidateIndexFile();
+
+			if (!MoveRawData(Record.HeaderOffset, PackedEnd, EntrySpan))
+			{
+				UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to move tar entry '%s' from offset %lld to offset %lld"), *Record.Name, Record.HeaderOffset, PackedEnd);
+				return false;
+			}
+
+			const int64 OldHeaderOffset = Record.HeaderOffset;
+			Record.HeaderOffset -= VacatedSize;
+			Record.DataOffset -= VacatedSize;
+			UpdateMovedEntryRecord(Record, OldHeaderOffset);
+			MovedBytes += EntrySpan;
+
+			// Vacating the region the entry was moved out of keeps the archive valid if the compaction stops before the next entry
+			if (Index < EntryRecords.Num() - 1 && !VacateRegion(PackedEnd + EntrySpan, VacatedSize))
+			{
+				return false;
+			}
+		}
+
+		PackedEnd += EntrySpan;
+	}
+
+	bIsCompacted = Index == EntryRecords.Num();
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Moved %lld bytes of tar entries while compacting. Entries left to move: %d"), MovedBytes, EntryRecords.Num() - Index);
+
+	// The next entries and the end-of-archive marker are written right after the last entry
+	if (bIsCompacted && PackedEnd != Stream->Tell())
+	{
+		bHasStaleTail = true;
+		return Stream->Seek(PackedEnd);
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::ReserveEntry(const FTarHeader& Header, int64& DataOffset)
+{
+	FScopeLock Lock(&WriteLock);
+
+	if (RemainingDataSize != 0)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to reserve tar entry because %lld bytes of the previous entry data have not been written yet"), RemainingDataSize);
+		return false;
+	}
+
+	if (!WriteHeader(Header))
+	{
+		return false;
+	}
+
+	// The reserved region is left as is until its data arrives, so the write position moves straight past it
+	const int64 DataSize = RemainingDataSize;
+	RemainingDataSize = 0;
 
-bool URuntimeArchiverTar::CreateArchiveInStorage(FString ArchivePath)
+	if (!FlushWriteBuffer())
+	{
+		return false;
+	}
+
+	DataOffset = Stream->Tell();
+
+	if (!Stream->Seek(DataOffset + RuntimeArchiverTarOperations::RoundUp<int64>(DataSize, 512)))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to reserve %lld bytes of tar entry data at offset %lld"), DataSize, DataOffset);
+		return false;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::WriteReservedData(int64 DataOffset, const void* Data, int64 Size)
 {
-	if (!Super::CreateArchiveInStorage(ArchivePath))
+	static const uint8 NullBlock[512]{};
+
+	const int64 PaddingSize = RuntimeArchiverTarOperations::RoundUp<int64>(Size, 512) - Size;
+
+	// Hashed before taking the lock, so that the producers hash their data at the same time
+	const uint32 Checksum = bComputeChecksums ? FRuntimeArchiverHashingStream::UpdateChecksum(0, Data, Size) : 0;
+
+	// The region was flushed past on reservation and the write buffer only holds the data after it, so the data is written positionally without the write lock
+	// and the producers do not wait for each other or for the reservations
+	if (!Stream->WriteAt(DataOffset, Data, Size) || !Stream->WriteAt(DataOffset + Size, NullBlock, PaddingSize))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write %lld bytes of reserved tar entry data at offset %lld"), Size, DataOffset);
+		AbandonReservedEntry(DataOffset, Size);
+		return false;
+	}
+
+	if (bComputeChecksums)
+	{
+		// The entry index grows while the other producers reserve their entries
+		FScopeLock Lock(&WriteLock);
+		SetEntryChecksum(FindEntryIndexByHeaderOffset(DataOffset - sizeof(FTarHeader)), Checksum);
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::BeginStreamedEntry(const FTarHeader& Header)
+{
+	if (RemainingDataSize != 0)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to begin streamed tar entry because %lld bytes of the previous entry data have not been written yet"), RemainingDataSize);
+		return false;
+	}
+
+	if (!WriteHeader(Header))
+	{
+		return false;
+	}
+
+	StreamedEntryHeader = MakeUnique<FTarHeader>(Header);
+	StreamedEntrySize = 0;
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::AppendStreamedEntryData(const void* Data, int64 Size)
+{
+	if (!StreamedEntryHeader.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to append tar entry data because no entry is being streamed"));
+		return false;
+	}
+
+	if (!BufferedWrite(Data, Size))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write streamed tar entry data"));
+		return false;
+	}
+
+	if (bComputeChecksums)
+	{
+		CurrentEntryChecksum = FRuntimeArchiverHashingStream::UpdateChecksum(CurrentEntryChecksum, Data, Size);
+	}
+
+	StreamedEntrySize += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::EndStreamedEntry()
+{
+	if (!StreamedEntryHeader.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to end streamed tar entry because no entry is being streamed"));
+		return false;
+	}
+
+	const TUniquePtr<FTarHeader> Header = MoveTemp(StreamedEntryHeader);
+	FRuntimeArchiverTarEntryRecord& Record = EntryRecords.Last();
+
+	if (!WriteNullBytes(RuntimeArchiverTarOperations::RoundUp<int64>(StreamedEntrySize, 512) - StreamedEntrySize))
+	{
+		return false;
+	}
+
+	Header->Resize(StreamedEntrySize);
+
+	// Small entries still have their header in the write buffer, so it is patched there without seeking back
+	const int64 BufferOffset = Stream->Tell();
+
+	if (Record.HeaderOffset >= BufferOffset)
+	{
+		FMemory::Memcpy(WriteBuffer.GetData() + (Record.HeaderOffset - BufferOffset), Header.Get(), sizeof(FTarHeader));
+	}
+	else if (!WriteRawData(Record.HeaderOffset, Header.Get(), sizeof(FTarHeader)))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to patch header of streamed tar entry '%s' at offset %lld"), *Record.Name, Record.HeaderOffset);
+		return false;
+	}
+
+	Record.Size = StreamedEntrySize;
+	Record.RealSize = StreamedEntrySize;
+
+	if (bComputeChecksums)
+	{
+		SetEntryChecksum(EntryRecords.Num() - 1, CurrentEntryChecksum);
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::ReadHeaderByIndex(int32 Index, FTarHeader& Header, bool bRemainPosition)
+{
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar header because stream is invalid"));
+		return false;
+	}
+
+	if (!EntryRecords.IsValidIndex(Index))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar header at index %d. Number of entries: %d"), Index, EntryRecords.Num());
+		return false;
+	}
+
+	// The header may still be in the write buffer
+	if (Stream->IsWrite() && !FlushWriteBuffer())
+	{
+		return false;
+	}
+
+	const int64 PrevRemainingDataSize = RemainingDataSize;
+	const int64 PrevLastHeaderPosition = LastHeaderPosition;
+	const int64 PrevStreamPosition = Stream->Tell();
+
+	LastHeaderPosition = EntryRecords[Index].HeaderOffset;
+	RemainingDataSize = 0;
+
+	const bool bSuccess = Stream->Seek(LastHeaderPosition) && Stream->Read(&Header, sizeof(Header)) && Stream->Seek(LastHeaderPosition);
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar header at offset %lld"), LastHeaderPosition);
+	}
+
+	if (bRemainPosition)
+	{
+		RemainingDataSize = PrevRemainingDataSize;
+		LastHeaderPosition = PrevLastHeaderPosition;
+		Stream->Seek(PrevStreamPosition);
+	}
+
+	return bSuccess;
+}
+
+void FRuntimeArchiverTarEncapsulator::SetStream(TUniquePtr<FRuntimeArchiverBaseStream> InStream)
+{
+	if (!bComputeChecksums)
+	{
+		Stream = MoveTemp(InStream);
+		return;
+	}
+
+	HashingStream = new FRuntimeArchiverHashingStream(MoveTemp(InStream));
+	Stream.Reset(HashingStream);
+}
+
+int32 FRuntimeArchiverTarEncapsulator::FindEntryIndexByHeaderOffset(int64 HeaderOffset) const
+{
+	// The entries are indexed in the order of their position in the archive
+	const int32 Index = Algo::LowerBoundBy(EntryRecords, HeaderOffset, [](const FRuntimeArchiverTarEntryRecord& Record) { return Record.HeaderOffset; });
+
+	return EntryRecords.IsValidIndex(Index) && EntryRecords[Index].HeaderOffset == HeaderOffset ? Index : INDEX_NONE;
+}
+
+void FRuntimeArchiverTarEncapsulator::AddEntryRecord(FRuntimeArchiverTarEntryRecord&& Record)
+{
+	// In case of duplicate names, the first entry takes precedence
+	if (!EntryHeaderOffsetsByName.Contains(Record.Name))
+	{
+		EntryHeaderOffsetsByName.Add(Record.Name, Record.HeaderOffset);
+	}
+	else
+	{
+		bHasDuplicateNames = true;
+	}
+
+	if (!Record.LinkName.IsEmpty())
+	{
+		++NumOfHardLinksByTargetName.FindOrAdd(Record.LinkName);
+	}
+
+	EntryRecords.Add(MoveTemp(Record));
+}
+
+void FRuntimeArchiverTarEncapsulator::RemoveEntryRecord(int32 Index)
+{
+	FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+
+	const int64* HeaderOffset = EntryHeaderOffsetsByName.Find(Record.Name);
+
+	if (HeaderOffset && *HeaderOffset == Record.HeaderOffset)
+	{
+		EntryHeaderOffsetsByName.Remove(Record.Name);
+
+		// The name now resolves to the next entry with the same name, which can only follow the removed one
+		for (int32 RecordIndex = Index + 1; bHasDuplicateNames && RecordIndex < EntryRecords.Num(); ++RecordIndex)
+		{
+			if (EntryRecords[RecordIndex].Name.Equals(Record.Name, ESearchCase::CaseSensitive))
+			{
+				EntryHeaderOffsetsByName.Add(Record.Name, EntryRecords[RecordIndex].HeaderOffset);
+				break;
+			}
+		}
+	}
+
+	ForgetEntryContent(Record);
+	EntryRecords.RemoveAt(Index);
+}
+
+void FRuntimeArchiverTarEncapsulator::ForgetEntryContent(FRuntimeArchiverTarEntryRecord& Record)
+{
+	if (!Record.LinkName.IsEmpty())
+	{
+		int32* NumOfHardLinks = NumOfHardLinksByTargetName.Find(Record.LinkName);
+
+		if (NumOfHardLinks && --*NumOfHardLinks <= 0)
+		{
+			NumOfHardLinksByTargetName.Remove(Record.LinkName);
+		}
+
+		Record.LinkName.Reset();
+	}
+
+	if (Record.bHasContentHash)
+	{
+		if (TArray<int64>* HeaderOffsets = EntryHeaderOffsetsByContentHash.Find(Record.ContentHash))
+		{
+			HeaderOffsets->Remove(Record.HeaderOffset);
+
+			if (HeaderOffsets->Num() == 0)
+			{
+				EntryHeaderOffsetsByContentHash.Remove(Record.ContentHash);
+			}
+		}
+
+		Record.bHasContentHash = false;
+	}
+}
+
+void FRuntimeArchiverTarEncapsulator::UpdateMovedEntryRecord(const FRuntimeArchiverTarEntryRecord& Record, int64 OldHeaderOffset)
+{
+	int64* HeaderOffset = EntryHeaderOffsetsByName.Find(Record.Name);
+
+	if (HeaderOffset && *HeaderOffset == OldHeaderOffset)
+	{
+		*HeaderOffset = Record.HeaderOffset;
+	}
+
+	TArray<int64>* ContentHashHeaderOffsets = Record.bHasContentHash ? EntryHeaderOffsetsByContentHash.Find(Record.ContentHash) : nullptr;
+
+	if (ContentHashHeaderOffsets)
+	{
+		for (int64& ContentHashHeaderOffset : *ContentHashHeaderOffsets)
+		{
+			if (ContentHashHeaderOffset == OldHeaderOffset)
+			{
+				ContentHashHeaderOffset = Record.HeaderOffset;
+			}
+		}
+	}
+}
+
+void FRuntimeArchiverTarEncapsulator::InvalidateIndexFile()
+{
+	if (bIsIndexFileInvalidated || ArchiveFilePath.IsEmpty())
+	{
+		return;
+	}
+
+	bIsIndexFileInvalidated = true;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString IndexFilePath = GetIndexFilePath();
+
+	if (PlatformFile.FileExists(*IndexFilePath) && !PlatformFile.DeleteFile(*IndexFilePath))
+	{
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Unable to delete tar index file '%s' of the archive modified in place"), *IndexFilePath);
+	}
+}
+
+bool FRuntimeArchiverTarEncapsulator::VacateRegion(int64 Offset, int64 Size)
+{
+	for (int64 RecordOffset = Offset; RecordOffset < Offset + Size;)
+	{
+		const int64 RecordSize = FMath::Min<int64>(Offset + Size - RecordOffset, MaxVacatedRecordSize);
+
+		FTarHeader Header;
+		const int64 DataSize = RecordSize - sizeof(FTarHeader);
+
+		if (!FTarHeader::GenerateVacatedHeader(DataSize, Header) || !WriteRawData(RecordOffset, &Header, sizeof(Header)))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to vacate %lld bytes of tar archive at offset %lld"), RecordSize, RecordOffset);
+			return false;
+		}
+
+		// The data is a single comment record spanning all of it, so the stale data in between does not have to be overwritten
+		if (DataSize > 0)
+		{
+			const FString RecordPrefix = FString::Printf(TEXT("%lld comment="), DataSize);
+			const auto RecordPrefixAnsi = StringCast<ANSICHAR>(*RecordPrefix);
+
+			if (!WriteRawData(RecordOffset + sizeof(FTarHeader), RecordPrefixAnsi.Get(), RecordPrefixAnsi.Length()) || !WriteRawData(RecordOffset + RecordSize - 1, "\n", 1))
+			{
+				return false;
+			}
+		}
+
+		RecordOffset += RecordSize;
+	}
+
+	return true;
+}
+
+void FRuntimeArchiverTarEncapsulator::AbandonReservedEntry(int64 DataOffset, int64 Size)
+{
+	FScopeLock Lock(&WriteLock);
+
+	const int64 HeaderOffset = DataOffset - sizeof(FTarHeader);
+	const int32 Index = FindEntryIndexByHeaderOffset(HeaderOffset);
+
+	// The vacated region cannot continue into the next volume the way the entry data does, so volumes are not vacated
+	if (Index != INDEX_NONE && !IsMultiVolume())
+	{
+		InvalidateIndexFile();
+		RemoveEntryRecord(Index);
+
+		// The entries reserved after it may already be written, so the region is vacated in place even if it is the last one
+		if (VacateRegion(HeaderOffset, sizeof(FTarHeader) + RuntimeArchiverTarOperations::RoundUp<int64>(Size, 512)))
+		{
+			return;
+		}
+	}
+
+	UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to vacate reserved tar entry at offset %lld. The archive is damaged and will not be finalized"), HeaderOffset);
+	bHasDamagedEntry = true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::GetArchiveEntries(int32& NumOfArchiveEntries)
+{
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive entries because stream is invalid"));
+		return false;
+	}
+
+	NumOfArchiveEntries = EntryRecords.Num();
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::GetArchiveData(TArray64<uint8>& ArchiveData)
+{
+	if (!IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive data because stream is invalid"));
+		return false;
+	}
+
+	if (Stream->IsWrite() && !Finalize())
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive data because finalization failed"));
+		return false;
+	}
+
+	// The segments are copied as they are, without moving the position of the archive being written
+	if (SegmentedMemoryStream)
+	{
+		SegmentedMemoryStream->GetContiguousData(ArchiveData);
+		return true;
+	}
+
+	ArchiveData.SetNumUninitialized(Stream->Size());
+
+	const int64 PrevRemainingDataSize = RemainingDataSize;
+	const int64 PrevLastHeaderPosition = LastHeaderPosition;
+	const int64 PrevStreamPosition = Stream->Tell();
+
+	Rewind();
+
+	if (!Stream->Read(ArchiveData.GetData(), ArchiveData.Num()))
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar archive data with size '%lld'"), ArchiveData.Num());
 		return false;
 	}
 
-	FPaths::NormalizeFilename(ArchivePath);
+	RemainingDataSize = PrevRemainingDataSize;
+	LastHeaderPosition = PrevLastHeaderPosition;
 
-	if (!TarEncapsulator->OpenFile(ArchivePath, true))
+	if (!Stream->Seek(PrevStreamPosition))
 	{
-		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open tar archive '%s' for writing"), *ArchivePath));
-		Reset();
 		return false;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully created tar archive '%s' in '%s'"), *GetName(), *ArchivePath);
-
 	return true;
 }
 
-bool URuntimeArchiverTar::CreateArchiveInMemory(int32 InitialAllocationSize)
+bool FRuntimeArchiverTarEncapsulator::Rewind()
 {
-	if (!Super::CreateArchiveInMemory(InitialAllocationSize))
+	if (!IsValid())
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to rewind read/write position of tar archive because stream is invalid"));
 		return false;
 	}
 
-	if (!TarEncapsulator->OpenMemory(TArray64<uint8>(), InitialAllocationSize, true))
+	RemainingDataSize = 0;
+	LastHeaderPosition = 0;
+	return Stream->Seek(0);
+}
+
+bool FRuntimeArchiverTarEncapsulator::Next()
+{
+	if (!IsValid())
 	{
-		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Unable to initialize tar archive in memory"));
-		Reset();
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get next tar archive data because stream is invalid"));
 		return false;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully created tar archive '%s' in memory"), *GetName());
-
-	return true;
-}
+	FTarHeader Header;
+	LastHeaderPosition = Stream->Tell();
 
-bool URuntimeArchiverTar::OpenArchiveFromStorage(FString ArchivePath)
-{
-	if (!Super::OpenArchiveFromStorage(ArchivePath))
+	// Reading the header directly since the position is moved past the entry anyway
+	if (!Stream->Read(&Header, sizeof(Header)))
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read header for getting next tar entry data"));
 		return false;
 	}
 
-	FPaths::NormalizeFilename(ArchivePath);
-
-	if (!TarEncapsulator->OpenFile(ArchivePath, false))
+	if (!SkipSparseExtensionHeaders(Header))
 	{
-		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open tar archive '%s' for writing"), *ArchivePath));
-		Reset();
 		return false;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully opened tar archive '%s' in '%s' to read"), *GetName(), *ArchivePath);
+	const int64 NextEntryOffset = Stream->Tell() + RuntimeArchiverTarOperations::RoundUp<int64>(Header.GetSize(), 512);
 
-	return true;
+	UE_LOG(LogRuntimeArchiver, Verbose, TEXT("Seeking to next tar entry at offset %lld"), NextEntryOffset);
+
+	return Stream->Seek(NextEntryOffset);
 }
 
-bool URuntimeArchiverTar::OpenArchiveFromMemory(const TArray64<uint8>& ArchiveData)
+bool FRuntimeArchiverTarEncapsulator::ReadHeader(FTarHeader& Header)
 {
-	if (!Super::OpenArchiveFromMemory(ArchiveData))
+	LastHeaderPosition = Stream->Tell();
+
+	// Make sure that we will read valid data (the last 2 entries in the archive are not valid)
 	{
-		return false;
+		const int64 PotentialMaxPosition = (sizeof(FTarHeader) * 2) + Stream->Tell() + sizeof(Header);
+
+		if (PotentialMaxPosition > Stream->Size())
+		{
+			return false;
+		}
 	}
 
-	if (!TarEncapsulator->OpenMemory(ArchiveData, 0, false))
+	if (!Stream->Read(&Header, sizeof(Header)))
 	{
-		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Unable to open in-memory tar archive to read"));
-		Reset();
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read header from stream"));
 		return false;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully opened in-memory tar archive '%s' to read"), *GetName());
+	// Seek back to start of header
+	if (!Stream->Seek(LastHeaderPosition))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to seek back to start of header"));
+		return false;
+	}
 
 	return true;
 }
 
-bool URuntimeArchiverTar::CloseArchive()
+bool FRuntimeArchiverTarEncapsulator::ReadData(TArray64<uint8>& Data)
 {
-	if (!Super::CloseArchive())
+	return ReadData(Data.GetData(), Data.Num());
+}
+
+bool FRuntimeArchiverTarEncapsulator::ReadData(void* Data, int64 Size)
+{
+	// If there is no remaining data, then this is the first reading. Getting the size, setting the remaining data and seeking to the beginning of the data
+	if (RemainingDataSize == 0)
+	{
+		FTarHeader Header;
+		if (!ReadHeader(Header))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read header for getting tar entry data"));
+			return false;
+		}
+
+		if (!Stream->Seek(Stream->Tell() + sizeof(FTarHeader)))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to seek to next header for getting tar entry data"));
+			return false;
+		}
+
+		if (!SkipSparseExtensionHeaders(Header))
+		{
+			return false;
+		}
+
+		RemainingDataSize = Header.GetSize();
+		CurrentEntryChecksum = 0;
+	}
+
+	if (Size > RemainingDataSize)
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read %lld bytes of tar entry data because only %lld bytes remain"), Size, RemainingDataSize);
 		return false;
 	}
 
-	Reset();
+	if (!Stream->Read(Data, Size))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar entry data"));
+		return false;
+	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully closed tar archive '%s'"), *GetName());
+	if (bComputeChecksums)
+	{
+		CurrentEntryChecksum = FRuntimeArchiverHashingStream::UpdateChecksum(CurrentEntryChecksum, Data, Size);
+	}
+
+	RemainingDataSize -= Size;
+
+	// If there is no remaining data, then we have finished reading and seek back to the header
+	if (RemainingDataSize == 0)
+	{
+		if (bComputeChecksums)
+		{
+			SetEntryChecksum(FindEntryIndexByHeaderOffset(LastHeaderPosition), CurrentEntryChecksum);
+		}
+
+		return Stream->Seek(LastHeaderPosition);
+	}
 
 	return true;
 }
 
-bool URuntimeArchiverTar::GetArchiveData(TArray64<uint8>& ArchiveData)
+bool FRuntimeArchiverTarEncapsulator::WriteHeader(const FTarHeader& Header)
 {
-	if (!Super::GetArchiveData(ArchiveData))
+	return WriteHeader(Header, TArray<FTarSparseHeader>(), TArray<FRuntimeArchiverTarSparseRegion>());
+}
+
+bool FRuntimeArchiverTarEncapsulator::WriteHeader(const FTarHeader& Header, const TArray<FTarSparseHeader>& ExtensionHeaders, const TArray<FRuntimeArchiverTarSparseRegion>& SparseRegions)
+{
+	if (StreamedEntryHeader.IsValid())
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write tar entry header while entry '%s' is being streamed"), StringCast<TCHAR>(StreamedEntryHeader->GetName()).Get());
 		return false;
 	}
 
-	const bool bSuccess = TarEncapsulator->GetArchiveData(ArchiveData);
+	const int64 HeaderOffset = GetWritePosition();
 
-	if (!bSuccess)
+	RemainingDataSize = Header.GetSize();
+
+	if (!BufferedWrite(&Header, sizeof(Header)))
 	{
-		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get tar archive data from memory"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write tar entry header"));
 		return false;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar archive data from memory with size '%lld'"), ArchiveData.Num());
+	if (ExtensionHeaders.Num() > 0 && !BufferedWrite(ExtensionHeaders.GetData(), ExtensionHeaders.Num() * sizeof(FTarSparseHeader)))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write tar sparse extension headers"));
+		return false;
+	}
 
-	return true;
-}
+	// Keeping the entry index up to date
+	FRuntimeArchiverTarEntryRecord Record;
+	Record.Name = StringCast<TCHAR>(Header.GetName()).Get();
+	Record.HeaderOffset = HeaderOffset;
+	Record.DataOffset = HeaderOffset + sizeof(FTarHeader) + ExtensionHeaders.Num() * sizeof(FTarSparseHeader);
+	Record.Size = RemainingDataSize;
+	Record.RealSize = Header.GetRealSize();
+	Record.SparseRegions = SparseRegions;
 
-bool URuntimeArchiverTar::GetArchiveEntries(int32& NumOfArchiveEntries)
-{
-	if (!Super::GetArchiveEntries(NumOfArchiveEntries))
+	if (Header.IsHardLink())
 	{
-		return false;
+		Record.LinkName = Header.GetLinkTargetName();
 	}
 
-	if (!TarEncapsulator->GetArchiveEntries(NumOfArchiveEntries))
+	CurrentEntryChecksum = 0;
+
+	// Entries without data are complete once the header is written
+	if (bComputeChecksums && RemainingDataSize == 0)
 	{
-		ReportError(ERuntimeArchiverErrorCode::GetError, TEXT("Unable to get number of tar entries"));
-		return false;
+		Record.Checksum = 0;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved %d tar entries"), NumOfArchiveEntries);
+	AddEntryRecord(MoveTemp(Record));
+
 	return true;
 }
 
-bool URuntimeArchiverTar::GetArchiveEntryInfoByName(FString EntryName, FRuntimeArchiveEntry& EntryInfo)
+bool FRuntimeArchiverTarEncapsulator::WriteData(const TArray64<uint8>& DataToBeArchived)
 {
-	if (!Super::GetArchiveEntryInfoByName(EntryName, EntryInfo))
+	return WriteData(DataToBeArchived.GetData(), DataToBeArchived.Num());
+}
+
+bool FRuntimeArchiverTarEncapsulator::WriteData(const void* Data, int64 Size)
+{
+	if (Size > RemainingDataSize)
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write %lld bytes of tar entry data because only %lld bytes remain according to the header"), Size, RemainingDataSize);
 		return false;
 	}
 
-	FTarHeader Header;
-	int32 EntryIndex;
-
-	// Searching for a header by the entry name
-	const bool bFound = TarEncapsulator->FindIf([&EntryName](const FTarHeader& PossibleHeader, int32 PossibleIndex)
-	{
-		return EntryName.Equals(StringCast<TCHAR>(PossibleHeader.GetName()).Get());
-	}, Header, EntryIndex, true);
-
-	if (!bFound)
+	if (!BufferedWrite(Data, Size))
 	{
-		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Unable to find the entry index under the entry name '%s'"), *EntryName));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write tar entry data"));
 		return false;
 	}
 
-	if (!FTarHeader::ToEntry(Header, EntryIndex, EntryInfo))
+	if (bComputeChecksums)
 	{
-		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Failed to convert tar header to entry with entry name '%s'"), *EntryName));
-		return false;
+		CurrentEntryChecksum = FRuntimeArchiverHashingStream::UpdateChecksum(CurrentEntryChecksum, Data, Size);
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar entry '%s' by name"), *EntryInfo.Name);
+	RemainingDataSize -= Size;
+
+	// Write padding if all data for this entry has already been written
+	if (RemainingDataSize == 0)
+	{
+		if (bComputeChecksums)
+		{
+			SetEntryChecksum(EntryRecords.Num() - 1, CurrentEntryChecksum);
+		}
+
+		const int64 CurrentPosition{GetWritePosition()};
+		return WriteNullBytes(RuntimeArchiverTarOperations::RoundUp<int64>(CurrentPosition, 512) - CurrentPosition);
+	}
 
 	return true;
 }
 
-bool URuntimeArchiverTar::GetArchiveEntryInfoByIndex(int32 EntryIndex, FRuntimeArchiveEntry& EntryInfo)
+bool FRuntimeArchiverTarEncapsulator::AbandonEntryData()
 {
-	if (!Super::GetArchiveEntryInfoByIndex(EntryIndex, EntryInfo))
+	if (RemainingDataSize == 0 || EntryRecords.Num() == 0)
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to abandon tar entry because no entry data is being written"));
 		return false;
 	}
 
-	FTarHeader Header;
+	// The headers that follow are expected right after the data declared in the header, so the archive stays readable whether the entry is removed or not
+	const int64 CurrentPosition{GetWritePosition()};
+	const int64 NullSize = RuntimeArchiverTarOperations::RoundUp<int64>(CurrentPosition + RemainingDataSize, 512) - CurrentPosition;
 
-	// Searching for a header by the entry index
-	const bool bFound = TarEncapsulator->FindIf([EntryIndex](const FTarHeader& PossibleHeader, int32 PossibleIndex)
-	{
-		return EntryIndex == PossibleIndex;
-	}, Header, EntryIndex, true);
+	RemainingDataSize = 0;
 
-	if (!bFound)
+	if (!WriteNullBytes(NullSize))
 	{
-		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Unable to find tar header at index %d"), EntryIndex));
 		return false;
 	}
 
-	if (!FTarHeader::ToEntry(Header, EntryIndex, EntryInfo))
+	if (IsMultiVolume())
 	{
-		ReportError(ERuntimeArchiverErrorCode::GetError, FString::Printf(TEXT("Failed to convert tar header to entry with entry index '%d'"), EntryIndex));
-		return false;
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Tar entry '%s' was abandoned and kept with zero-filled data, since entries of archives split into volumes cannot be removed"), *EntryRecords.Last().Name);
+		return true;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully retrieved tar entry '%s' by index"), *EntryInfo.Name);
-
-	return true;
+	return RemoveEntry(EntryRecords.Num() - 1);
 }
 
-bool URuntimeArchiverTar::AddEntryFromMemory(FString EntryName, const TArray64<uint8>& DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel)
+bool FRuntimeArchiverTarEncapsulator::WriteNullBytes(int64 NumOfBytes)
 {
-	if (!Super::AddEntryFromMemory(EntryName, DataToBeArchived, CompressionLevel))
+	if (!BufferedWrite(nullptr, NumOfBytes))
 	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write null bytes to tar archive"));
 		return false;
 	}
 
-	// Adding directory entries separately as required by the tar specification
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::FlushWriteBuffer()
+{
+	if (WriteBuffer.Num() == 0)
 	{
-		// Parsing directories from entry name
-		TArray<FString> Directories = URuntimeArchiverUtilities::ParseDirectories(EntryName);
+		return true;
+	}
 
-		for (const FString& Directory : Directories)
-		{
-			FTarHeader Header;
-			int32 Index;
+	const bool bSuccess = Stream->Write(WriteBuffer.GetData(), WriteBuffer.Num());
 
-			// Skip if the archive already contains this directory entry
-			const bool bFound = TarEncapsulator->FindIf([&Directory](const FTarHeader& PotentialHeader, int32 Index)
-			{
-				return Directory.Equals(StringCast<TCHAR>(PotentialHeader.GetName()).Get());
-			}, Header, Index, true);
+	if (!bSuccess)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to flush %lld buffered bytes to tar archive"), WriteBuffer.Num());
+	}
 
-			if (!bFound)
-			{
-				if (!FTarHeader::GenerateHeader(Directory, 0, FDateTime::Now(), true, Header))
-				{
-					ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate directory header for for entry '%s' to write from memory"), *Directory));
-					return false;
-				}
+	WriteBuffer.Reset();
 
-				// Directories only require writing a header, no data
-				if (!TarEncapsulator->WriteHeader(Header))
-				{
-					ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write header for entry '%s' from memory"), *Directory));
-					return false;
-				}
-			}
-		}
-	}
+	return bSuccess;
+}
 
-	FTarHeader Header;
-	if (!FTarHeader::GenerateHeader(EntryName, DataToBeArchived.Num(), FDateTime::Now(), false, Header))
-	{
-		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to generate file header for for entry '%s' to write from memory"), *EntryName));
-		return false;
-	}
+bool FRuntimeArchiverTarEncapsulator::BufferedWrite(const void* Data, int64 Size)
+{
+	const uint8* DataPtr = static_cast<const uint8*>(Data);
 
-	// Archiving data
+	while (Size > 0)
 	{
-		if (!TarEncapsulator->WriteHeader(Header))
+		// Large data is written directly, bypassing the buffer, as long as it keeps the buffer empty
+		if (WriteBuffer.Num() == 0 && DataPtr && Size >= WriteBufferCapacity)
 		{
-			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write header for entry '%s' from memory"), *EntryName));
-			return false;
+			const int64 DirectSize = WriteBufferCapacity > 0 ? Size - Size % sizeof(FTarHeader) : Size;
+
+			if (!Stream->Write(DataPtr, DirectSize))
+			{
+				return false;
+			}
+
+			DataPtr += DirectSize;
+			Size -= DirectSize;
+			continue;
 		}
 
-		if (!TarEncapsulator->WriteData(DataToBeArchived))
+		// Null bytes are written in block-sized chunks when the buffering is disabled
+		if (WriteBufferCapacity == 0)
 		{
-			ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to write data for entry '%s' from memory"), *EntryName));
-			return false;
-		}
-	}
+			static const uint8 NullBlock[512]{};
+			const int64 ChunkSize = FMath::Min<int64>(Size, sizeof(NullBlock));
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully added tar entry '%s' with size %lld bytes from memory"), *EntryName, DataToBeArchived.Num());
+			if (!Stream->Write(NullBlock, ChunkSize))
+			{
+				return false;
+			}
 
-	return true;
-}
+			Size -= ChunkSize;
+			continue;
+		}
 
-bool URuntimeArchiverTar::ExtractEntryToMemory(const FRuntimeArchiveEntry& EntryInfo, TArray64<uint8>& UnarchivedData)
-{
-	if (!Super::ExtractEntryToMemory(EntryInfo, UnarchivedData))
-	{
-		return false;
-	}
+		if (WriteBuffer.Max() < WriteBufferCapacity)
+		{
+			WriteBuffer.Reserve(WriteBufferCapacity);
+		}
 
-	int32 NumOfArchiveEntries;
-	if (!GetArchiveEntries(NumOfArchiveEntries) || EntryInfo.Index > (NumOfArchiveEntries - 1))
-	{
-		ReportError(ERuntimeArchiverErrorCode::InvalidArgument, FString::Printf(TEXT("Tar entry index %d is invalid. Min index: 0, Max index: %d"), EntryInfo.Index, (NumOfArchiveEntries - 1)));
-		return false;
-	}
+		const int64 ChunkSize = FMath::Min<int64>(Size, WriteBufferCapacity - WriteBuffer.Num());
 
-	FTarHeader Header;
-	int32 Index;
+		if (DataPtr)
+		{
+			WriteBuffer.Append(DataPtr, ChunkSize);
+			DataPtr += ChunkSize;
+		}
+		else
+		{
+			WriteBuffer.AddZeroed(ChunkSize);
+		}
 
-	// Make sure we have such entry
-	const bool bFound = TarEncapsulator->FindIf([&EntryInfo](const FTarHeader& PotentialHeader, int32 Index)
-	{
-		return EntryInfo.Name.Equals(StringCast<TCHAR>(PotentialHeader.GetName()).Get());
-	}, Header, Index, false);
+		Size -= ChunkSize;
 
-	if (!bFound)
-	{
-		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to find tar entry '%s' to write into memory"), *EntryInfo.Name));
-		return false;
+		// The buffer is emitted as a single block-aligned write once full
+		if (WriteBuffer.Num() == WriteBufferCapacity && !FlushWriteBuffer())
+		{
+			return false;
+		}
 	}
 
-	UnarchivedData.SetNumUninitialized(Header.GetSize());
+	return true;
+}
 
-	if (!TarEncapsulator->ReadData(UnarchivedData))
+bool FRuntimeArchiverTarEncapsulator::SkipSparseExtensionHeaders(const FTarHeader& Header)
+{
+	for (bool bIsExtended = Header.IsExtendedHeader(); bIsExtended;)
 	{
-		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to read data from tar entry '%s' to write into memory"), *EntryInfo.Name));
-		UnarchivedData.Empty();
-		return false;
-	}
+		FTarSparseHeader ExtensionHeader;
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully extracted tar entry '%s' into memory"), *EntryInfo.Name);
+		if (!Stream->Read(&ExtensionHeader, sizeof(ExtensionHeader)))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar sparse extension header"));
+			return false;
+		}
+
+		bIsExtended = ExtensionHeader.IsExtendedHeader();
+	}
 
 	return true;
 }
 
-bool URuntimeArchiverTar::Initialize()
+bool FRuntimeArchiverTarEncapsulator::ReadRawData(int64 Offset, void* Data, int64 Size)
 {
-	if (!Super::Initialize())
+	// The data may still be in the write buffer
+	if (Stream->IsWrite() && !FlushWriteBuffer())
 	{
 		return false;
 	}
 
-	TarEncapsulator.Reset(new FRuntimeArchiverTarEncapsulator);
-
-	if (!TarEncapsulator)
+	if (!Stream->ReadAt(Offset, Data, Size))
 	{
-		ReportError(ERuntimeArchiverErrorCode::NotInitialized, TEXT("Unable to allocate memory for tar archiver"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read %lld bytes of tar archive data at offset %lld"), Size, Offset);
 		return false;
 	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully initialized tar archiver '%s'"), *GetName());
-
 	return true;
 }
 
-bool URuntimeArchiverTar::IsInitialized() const
-{
-	return Super::IsInitialized() && TarEncapsulator.IsValid() && TarEncapsulator->IsValid();
-}
-
-void URuntimeArchiverTar::Reset()
+bool FRuntimeArchiverTarEncapsulator::WriteRawData(int64 Offset, const void* Data, int64 Size)
 {
-	TarEncapsulator.Reset();
+	if (Size == 0)
+	{
+		return true;
+	}
 
-	Super::Reset();
+	// The buffered data must land before the data written here
+	if (!FlushWriteBuffer())
+	{
+		return false;
+	}
 
-	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully uninitialized tar archiver '%s'"), *GetName());
-}
+	if (!Stream->WriteAt(Offset, Data, Size))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write %lld bytes of tar archive data at offset %lld"), Size, Offset);
+		return false;
+	}
 
-void URuntimeArchiverTar::ReportError(ERuntimeArchiverErrorCode ErrorCode, const FString& ErrorString) const
-{
-	Super::ReportError(ErrorCode, ErrorString);
+	return true;
 }
 
-FRuntimeArchiverTarEncapsulator::FRuntimeArchiverTarEncapsulator()
-	: RemainingDataSize{0}
-  , LastHeaderPosition{0}
-  , CachedNumOfHeaders{0}
-  , bIsFinalized{false}
+bool FRuntimeArchiverTarEncapsulator::MoveRawData(int64 SourceOffset, int64 DestinationOffset, int64 Size)
 {
-}
+	TArray64<uint8> Buffer;
+	Buffer.SetNumUninitialized(FMath::Min<int64>(Size, StreamingChunkSize));
 
-FRuntimeArchiverTarEncapsulator::~FRuntimeArchiverTarEncapsulator()
-{
-	if (Stream.IsValid())
+	// Copying from the start never overwrites the data yet to be copied, since the data moves towards the start of the archive
+	for (int64 Offset = 0; Offset < Size; Offset += Buffer.Num())
 	{
-		if (Stream->IsWrite())
+		const int64 ChunkSize = FMath::Min<int64>(Size - Offset, Buffer.Num());
+
+		if (!ReadRawData(SourceOffset + Offset, Buffer.GetData(), ChunkSize) || !WriteRawData(DestinationOffset + Offset, Buffer.GetData(), ChunkSize))
 		{
-			Finalize();
+			return false;
 		}
-
-		Stream.Reset();
 	}
-}
 
-bool FRuntimeArchiverTarEncapsulator::IsValid()
-{
-	return Stream.IsValid() && Stream->IsValid();
+	return true;
 }
 
-bool FRuntimeArchiverTarEncapsulator::TestArchive()
+TArray<FRuntimeArchiverVolume> FRuntimeArchiverTarEncapsulator::GetArchiveVolumes() const
 {
-	if (Stream->IsWrite())
+	if (VolumeStream)
 	{
-		return true;
+		return VolumeStream->GetVolumes();
 	}
 
-	static FTarHeader Header{};
+	TArray<FRuntimeArchiverVolume> Volumes;
 
-	if (!Rewind())
+	if (!ArchiveFilePath.IsEmpty())
 	{
-		return false;
+		Volumes.Add(FRuntimeArchiverVolume{ArchiveFilePath, 0, Stream->Size(), 0});
 	}
 
-	return ReadHeader(Header);
+	return Volumes;
 }
 
-bool FRuntimeArchiverTarEncapsulator::OpenFile(const FString& ArchivePath, bool bWrite)
+int64 FRuntimeArchiverTarEncapsulator::GetEntryChecksum(int32 Index) const
 {
-	if (Stream.IsValid())
-	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
-		return false;
-	}
+	// The entry records grow under the same lock while the entries are reserved concurrently
+	FScopeLock Lock(&WriteLock);
+
+	return EntryRecords.IsValidIndex(Index) ? EntryRecords[Index].Checksum : -1;
+}
 
-	Stream.Reset(new FRuntimeArchiverFileStream(ArchivePath, bWrite));
+void FRuntimeArchiverTarEncapsulator::SetEntryChecksum(int32 Index, uint32 Checksum)
+{
+	FScopeLock Lock(&WriteLock);
 
-	if (!Stream->IsValid())
+	if (EntryRecords.IsValidIndex(Index))
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
-		return false;
+		EntryRecords[Index].Checksum = Checksum;
 	}
-
-	return TestArchive();
 }
 
-bool FRuntimeArchiverTarEncapsulator::OpenMemory(const TArray64<uint8>& ArchiveData, int32 InitialAllocationSize, bool bWrite)
+bool FRuntimeArchiverTarEncapsulator::GetArchiveChecksum(uint32& Checksum)
 {
-	if (Stream.IsValid())
+	if (!IsValid() || !HashingStream)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it has already been opened"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive checksum because stream is invalid or the checksums are not computed"));
 		return false;
 	}
 
-	Stream.Reset(bWrite ? new FRuntimeArchiverMemoryStream(InitialAllocationSize) : new FRuntimeArchiverMemoryStream(ArchiveData));
-
-	if (!IsValid())
+	// The volume headers are written to the volume files directly, so the hashed data does not match any of them
+	if (VolumeStream)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar stream because it is not valid"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get checksum of tar archive split into volumes"));
 		return false;
 	}
 
-	return TestArchive();
-}
-
-bool FRuntimeArchiverTarEncapsulator::FindIf(TFunctionRef<bool(const FTarHeader&, int32)> ComparePredicate, FTarHeader& Header, int32& Index, bool bRemainPosition)
-{
-	if (!IsValid())
+	// The data written after the checksum would not be covered by it
+	if (Stream->IsWrite() && !bIsFinalized)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to find tar entry because stream is invalid"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive checksum because the archive has not been finalized"));
 		return false;
 	}
 
-	const int64 PreviousPosition = Stream->Tell();
-
-	// Make sure looking from the start
-	if (!Rewind())
+	if (!HashingStream->GetChecksum(Checksum))
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to rewind read/write position of tar archive to find tar entry"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive checksum because the archive data could not be read"));
 		return false;
 	}
 
-	FTarHeader TempHeader;
-	int32 TempIndex = 0;
+	return true;
+}
+
+bool FRuntimeArchiverTarEncapsulator::WriteVolumeHeaders()
+{
+	const TArray<FRuntimeArchiverVolume> Volumes = VolumeStream->GetVolumes();
+	const FString ArchiveName = FPaths::GetCleanFilename(Volumes[0].Path);
 
-	bool bFound = false;
+	// Both the entries and the volumes are ordered by their position, so the entries are walked once
+	int32 Index = 0;
 
-	// Iterate all files until we hit an error or find the header
-	while (ReadHeader(TempHeader))
+	for (int32 VolumeIndex = 1; VolumeIndex < Volumes.Num(); ++VolumeIndex)
 	{
-		if (ComparePredicate(TempHeader, TempIndex))
-		{
-			Header = TempHeader;
-			Index = TempIndex;
+		const int64 VolumeStart = Volumes[VolumeIndex].Start;
 
-			bFound = true;
-			break;
+		while (Index < EntryRecords.Num() && GetEntryEnd(Index) <= VolumeStart)
+		{
+			++Index;
 		}
 
-		if (!Next())
+		FTarHeader Header;
+		bool bIsHeaderGenerated;
+
+		// GNU tar expects the entry cut by the start of the volume to be continued after a continuation header
+		if (Index < EntryRecords.Num() && EntryRecords[Index].DataOffset <= VolumeStart && EntryRecords[Index].Size > 0)
+		{
+			const FRuntimeArchiverTarEntryRecord& Record = EntryRecords[Index];
+			bIsHeaderGenerated = FTarHeader::GenerateContinuationHeader(Record.Name, Record.Size, VolumeStart - Record.DataOffset, FDateTime::Now(), Header);
+		}
+		else
 		{
-			break;
+			bIsHeaderGenerated = FTarHeader::GenerateVolumeHeader(FString::Printf(TEXT("%s Volume %d"), *ArchiveName, VolumeIndex + 1), FDateTime::Now(), Header);
 		}
 
-		TempIndex++;
+		if (!bIsHeaderGenerated || !VolumeStream->WriteVolumeHeader(VolumeIndex, &Header))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write the header of tar volume '%s'"), *Volumes[VolumeIndex].Path);
+			return false;
+		}
 	}
 
-	if (bRemainPosition)
-	{
-		Stream->Seek(PreviousPosition);
-	}
+	return true;
+}
 
-	return bFound;
+int64 FRuntimeArchiverTarEncapsulator::GetEntryEnd(int32 Index) const
+{
+	return EntryRecords[Index].DataOffset + RuntimeArchiverTarOperations::RoundUp<int64>(EntryRecords[Index].Size, 512);
 }
 
-bool FRuntimeArchiverTarEncapsulator::GetArchiveEntries(int32& NumOfArchiveEntries)
+int64 FRuntimeArchiverTarEncapsulator::GetEndOfEntriesOffset() const
 {
-	if (!IsValid())
-	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive entries because stream is invalid"));
-		return false;
-	}
+	return EntryRecords.Num() > 0 ? GetEntryEnd(EntryRecords.Num() - 1) : 0;
+}
 
-	// TODO: verify the validity of the last entry
+FString FRuntimeArchiverTarEncapsulator::GetIndexFilePath() const
+{
+	return ArchiveFilePath + TEXT(".idx");
+}
 
-	// Read-only mode is supposed to have a fixed (immutable) number of entries, so if possible, return the cached number of entries in this mode to improve performance
-	if (!Stream->IsWrite() && CachedNumOfHeaders > 0)
-	{
-		NumOfArchiveEntries = CachedNumOfHeaders;
-		return true;
-	}
+bool FRuntimeArchiverTarEncapsulator::ComputeFingerprint(int64 ArchiveSize, uint64& Fingerprint)
+{
+	const int64 SpanSize = FMath::Min<int64>(ArchiveSize, FingerprintSpanSize);
 
-	const int64 PreviousPosition = Stream->Tell();
+	TArray64<uint8> Span;
+	Span.SetNumUninitialized(SpanSize);
 
-	// Making sure looking from the start
-	if (!Rewind())
+	// The head covers the first entries and the tail covers the last ones together with the end-of-archive marker
+	if (!ReadRawData(0, Span.GetData(), SpanSize))
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to rewind read/write position of tar archive to get the number of archive entries"));
 		return false;
 	}
 
-	FTarHeader TempHeader;
-	int32 NumOfHeaders{0};
+	Fingerprint = CityHash64WithSeed(reinterpret_cast<const char*>(Span.GetData()), static_cast<uint32>(SpanSize), static_cast<uint64>(ArchiveSize));
 
-	// Iterate all files
-	while (ReadHeader(TempHeader))
+	if (!ReadRawData(ArchiveSize - SpanSize, Span.GetData(), SpanSize))
 	{
-		NumOfHeaders++;
-
-		if (!Next())
-		{
-			break;
-		}
+		return false;
 	}
 
-	Stream->Seek(PreviousPosition);
+	Fingerprint = CityHash64WithSeed(reinterpret_cast<const char*>(Span.GetData()), static_cast<uint32>(SpanSize), Fingerprint);
 
-	// Cache number of entries in read-only mode to improve performance
-	if (!Stream->IsWrite())
-	{
-		CachedNumOfHeaders = NumOfHeaders;
-	}
+	// Rewriting the middle of the archive changes neither its size nor the hashed spans, but it does change the modification time
+	const int64 ModificationTicks = FPlatformFileManager::Get().GetPlatformFile().GetTimeStamp(*ArchiveFilePath).GetTicks();
+	Fingerprint = CityHash64WithSeed(reinterpret_cast<const char*>(&ModificationTicks), sizeof(ModificationTicks), Fingerprint);
 
-	NumOfArchiveEntries = NumOfHeaders;
 	return true;
 }
 
-bool FRuntimeArchiverTarEncapsulator::GetArchiveData(TArray64<uint8>& ArchiveData)
+bool FRuntimeArchiverTarEncapsulator::SaveIndexFile()
 {
-	if (!IsValid())
+	// The modification time is only final once the buffered data has reached the file
+	if (!Stream->Flush())
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive data because stream is invalid"));
 		return false;
 	}
 
-	if (Stream->IsWrite() && !Finalize())
+	int64 ArchiveSize = Stream->Size();
+	uint64 Fingerprint;
+
+	if (!ComputeFingerprint(ArchiveSize, Fingerprint))
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get tar archive data because finalization failed"));
 		return false;
 	}
 
-	ArchiveData.SetNumUninitialized(Stream->Size());
+	TArray<uint8> IndexData;
+	FMemoryWriter Writer(IndexData);
 
-	const int64 PrevRemainingDataSize = RemainingDataSize;
-	const int64 PrevLastHeaderPosition = LastHeaderPosition;
-	const int64 PrevStreamPosition = Stream->Tell();
+	uint32 Magic = IndexFileMagic;
+	uint32 Version = IndexFileVersion;
+	int32 NumOfRecords = EntryRecords.Num();
 
-	Rewind();
+	Writer << Magic;
+	Writer << Version;
+	Writer << ArchiveSize;
+	Writer << Fingerprint;
+	Writer << NumOfRecords;
 
-	if (!Stream->Read(ArchiveData.GetData(), ArchiveData.Num()))
+	for (FRuntimeArchiverTarEntryRecord& Record : EntryRecords)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar archive data with size '%lld'"), ArchiveData.Num());
-		return false;
+		SerializeEntryRecord(Writer, Record);
 	}
 
-	RemainingDataSize = PrevRemainingDataSize;
-	LastHeaderPosition = PrevLastHeaderPosition;
-
-	if (!Stream->Seek(PrevStreamPosition))
+	if (!FFileHelper::SaveArrayToFile(IndexData, *GetIndexFilePath()))
 	{
 		return false;
 	}
 
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Saved tar index file '%s' with %d entries"), *GetIndexFilePath(), NumOfRecords);
+
 	return true;
 }
 
-bool FRuntimeArchiverTarEncapsulator::Rewind()
+bool FRuntimeArchiverTarEncapsulator::LoadIndexFile()
 {
-	if (!IsValid())
+	const FString IndexFilePath = GetIndexFilePath();
+
+	TArray<uint8> IndexData;
+
+	if (!FPaths::FileExists(IndexFilePath) || !FFileHelper::LoadFileToArray(IndexData, *IndexFilePath))
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to rewind read/write position of tar archive because stream is invalid"));
 		return false;
 	}
 
-	RemainingDataSize = 0;
-	LastHeaderPosition = 0;
-	return Stream->Seek(0);
-}
+	FMemoryReader Reader(IndexData);
 
-bool FRuntimeArchiverTarEncapsulator::Next()
-{
-	if (!IsValid())
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int64 ArchiveSize = 0;
+	uint64 Fingerprint = 0;
+	int32 NumOfRecords = 0;
+
+	Reader << Magic;
+	Reader << Version;
+	Reader << ArchiveSize;
+	Reader << Fingerprint;
+	Reader << NumOfRecords;
+
+	if (Reader.IsError() || Magic != IndexFileMagic || Version != IndexFileVersion || NumOfRecords < 0)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to get next tar archive data because stream is invalid"));
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Tar index file '%s' has an unsupported format and is ignored"), *IndexFilePath);
 		return false;
 	}
 
-	FTarHeader Header;
-	if (!ReadHeader(Header))
+	uint64 ArchiveFingerprint;
+
+	if (ArchiveSize != Stream->Size() || !ComputeFingerprint(ArchiveSize, ArchiveFingerprint) || ArchiveFingerprint != Fingerprint)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read header for getting next tar entry data"));
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Tar index file '%s' does not match the archive and is ignored"), *IndexFilePath);
 		return false;
 	}
 
-	const int64 NextEntryOffset = RuntimeArchiverTarOperations::RoundUp<int64>(Header.GetSize(), 512) + sizeof(FTarHeader);
-
-	UE_LOG(LogRuntimeArchiver, Verbose, TEXT("Seeking to next tar entry at offset %lld"), NextEntryOffset);
-
-	return Stream->Seek(Stream->Tell() + NextEntryOffset);
-}
-
-bool FRuntimeArchiverTarEncapsulator::ReadHeader(FTarHeader& Header)
-{
-	LastHeaderPosition = Stream->Tell();
+	TArray<FRuntimeArchiverTarEntryRecord> Records;
 
-	// Make sure that we will read valid data (the last 2 entries in the archive are not valid)
+	for (int32 Index = 0; Index < NumOfRecords; ++Index)
 	{
-		const int64 PotentialMaxPosition = (sizeof(FTarHeader) * 2) + Stream->Tell() + sizeof(Header);
+		FRuntimeArchiverTarEntryRecord& Record = Records.AddDefaulted_GetRef();
+		SerializeEntryRecord(Reader, Record);
 
-		if (PotentialMaxPosition > Stream->Size())
+		// The entries must lie within the archive
+		if (Reader.IsError() || Record.HeaderOffset < 0 || Record.DataOffset < Record.HeaderOffset + static_cast<int64>(sizeof(FTarHeader)) || Record.Size < 0 || Record.DataOffset + Record.Size > ArchiveSize)
 		{
+			UE_LOG(LogRuntimeArchiver, Warning, TEXT("Tar index file '%s' is damaged and is ignored"), *IndexFilePath);
 			return false;
 		}
 	}
 
-	if (!Stream->Read(&Header, sizeof(Header)))
+	for (FRuntimeArchiverTarEntryRecord& Record : Records)
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read header from stream"));
-		return false;
+		AddEntryRecord(MoveTemp(Record));
 	}
 
-	// Seek back to start of header
-	if (!Stream->Seek(LastHeaderPosition))
-	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to seek back to start of header"));
-		return false;
-	}
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Loaded tar entry index with %d entries from index file '%s'"), EntryRecords.Num(), *IndexFilePath);
 
 	return true;
 }
 
-bool FRuntimeArchiverTarEncapsulator::ReadData(TArray64<uint8>& Data)
+int64 FRuntimeArchiverTarEncapsulator::GetWritePosition() const
 {
-	// If there is no remaining data, then this is the first reading. Getting the size, setting the remaining data and seeking to the beginning of the data
-	if (RemainingDataSize == 0)
+	return Stream->Tell() + WriteBuffer.Num();
+}
+
+bool FRuntimeArchiverTarEncapsulator::Finalize()
+{
+	FScopeLock Lock(&WriteLock);
+
+	if (bHasDamagedEntry)
 	{
-		FTarHeader Header;
-		if (!ReadHeader(Header))
-		{
-			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read header for getting tar entry data"));
-			return false;
-		}
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to finalize tar archive because a reserved entry was left without its data"));
+		return false;
+	}
 
-		if (!Stream->Seek(Stream->Tell() + sizeof(FTarHeader)))
+	if (bIsFinalized)
+	{
+		return true;
+	}
+
+	if (StreamedEntryHeader.IsValid())
+	{
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Streamed tar entry '%s' was not ended before finalizing the archive. Ending it now"), StringCast<TCHAR>(StreamedEntryHeader->GetName()).Get());
+
+		if (!EndStreamedEntry())
 		{
-			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to seek to next header for getting tar entry data"));
 			return false;
 		}
+	}
 
-		RemainingDataSize = Header.GetSize();
+	if (!WriteNullBytes(sizeof(FTarHeader) * 2) || !FlushWriteBuffer())
+	{
+		return false;
 	}
 
-	if (!Stream->Read(Data.GetData(), Data.Num()))
+	// The volume headers depend on where the entries ended up, which is only known once all of them are written
+	if (VolumeStream && !WriteVolumeHeaders())
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar entry data"));
 		return false;
 	}
 
-	RemainingDataSize -= Data.Num();
+	// Removed or moved entries may have left data after the end-of-archive marker
+	if (bHasStaleTail && Stream->Size() > Stream->Tell() && !Stream->Truncate(Stream->Tell()))
+	{
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Unable to truncate tar archive to %lld bytes. The data after the end-of-archive marker is ignored by readers"), Stream->Tell());
+	}
 
-	// If there is no remaining data, then we have finished reading and seek back to the header
-	if (RemainingDataSize == 0)
+	// The archive remains valid without the index file, so failing to save it is not an error
+	if (bUseIndexFile && !ArchiveFilePath.IsEmpty() && !SaveIndexFile())
 	{
-		return Stream->Seek(LastHeaderPosition);
+		UE_LOG(LogRuntimeArchiver, Warning, TEXT("Unable to save tar index file '%s'. The archive will be scanned when opened"), *GetIndexFilePath());
 	}
 
+	// Only set once every step has succeeded, so that a failed finalization is reported again instead of being taken for a finalized archive
+	bIsFinalized = true;
+
 	return true;
 }
 
-bool FRuntimeArchiverTarEncapsulator::WriteHeader(const FTarHeader& Header)
+FRuntimeArchiverTarEntryReader::FRuntimeArchiverTarEntryReader(URuntimeArchiverTar* InArchiver, int64 InSize, TArray<FRuntimeArchiverTarSparseRegion> InSparseRegions)
+	: Archiver{InArchiver}
+  , Encapsulator{InArchiver->TarEncapsulator.Get()}
+  , Size{InSize}
+  , RemainingSize{InSize}
+  , SparseRegions{MoveTemp(InSparseRegions)}
+  , SparseRegionIndex{0}
 {
-	RemainingDataSize = Header.GetSize();
-	return Stream->Write(&Header, sizeof(Header));
 }
 
-bool FRuntimeArchiverTarEncapsulator::WriteData(const TArray64<uint8>& DataToBeArchived)
+bool FRuntimeArchiverTarEntryReader::Read(void* Data, int64 MaxSize, int64& BytesRead)
 {
-	if (!Stream->Write(DataToBeArchived.GetData(), DataToBeArchived.Num()))
+	BytesRead = 0;
+
+	if (!Archiver.IsValid() || Archiver->TarEncapsulator.Get() != Encapsulator || !Encapsulator->IsValid())
 	{
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write tar entry data"));
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar entry data because the archive has been closed"));
 		return false;
 	}
 
-	RemainingDataSize -= DataToBeArchived.Num();
+	int64 ChunkSize = FMath::Min<int64>(MaxSize, RemainingSize);
 
-	// Write padding if all data for this entry has already been written
-	if (RemainingDataSize == 0)
+	if (ChunkSize <= 0)
 	{
-		const int64 CurrentPosition{Stream->Tell()};
-		return WriteNullBytes(RuntimeArchiverTarOperations::RoundUp<int64>(CurrentPosition, 512) - CurrentPosition);
+		return true;
 	}
 
-	return true;
-}
-
-bool FRuntimeArchiverTarEncapsulator::WriteNullBytes(int64 NumOfBytes) const
-{
-	constexpr ANSICHAR NullCharacter = '\0';
-
-	for (int64 Index = 0; Index < NumOfBytes; ++Index)
+	if (SparseRegions.Num() > 0)
 	{
-		if (!Stream->Write(&NullCharacter, 1))
+		// Holes are produced as zeros without touching the archive
+		if (const int64 HoleSize = GetHoleSize())
 		{
-			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write null bytes to tar archive"));
-			return false;
+			ChunkSize = FMath::Min<int64>(ChunkSize, HoleSize);
+			FMemory::Memzero(Data, ChunkSize);
+
+			RemainingSize -= ChunkSize;
+			BytesRead = ChunkSize;
+			return true;
 		}
+
+		const FRuntimeArchiverTarSparseRegion& Region = SparseRegions[SparseRegionIndex];
+		ChunkSize = FMath::Min<int64>(ChunkSize, Region.Offset + Region.Size - (Size - RemainingSize));
+	}
+
+	if (!Encapsulator->ReadData(Data, ChunkSize))
+	{
+		return false;
 	}
 
+	RemainingSize -= ChunkSize;
+	BytesRead = ChunkSize;
+
 	return true;
 }
 
-bool FRuntimeArchiverTarEncapsulator::Finalize()
+int64 FRuntimeArchiverTarEntryReader::SkipHole()
 {
-	if (bIsFinalized)
+	const int64 HoleSize = GetHoleSize();
+	RemainingSize -= HoleSize;
+	return HoleSize;
+}
+
+int64 FRuntimeArchiverTarEntryReader::GetHoleSize()
+{
+	if (SparseRegions.Num() == 0)
 	{
-		return true;
+		return 0;
 	}
 
-	bIsFinalized = true;
+	const int64 Position = Size - RemainingSize;
+
+	while (SparseRegionIndex < SparseRegions.Num() && SparseRegions[SparseRegionIndex].Offset + SparseRegions[SparseRegionIndex].Size <= Position)
+	{
+		++SparseRegionIndex;
+	}
 
-	return WriteNullBytes(sizeof(FTarHeader) * 2);
+	// The content after the last region is a hole as well
+	const int64 HoleEnd = SparseRegionIndex < SparseRegions.Num() ? FMath::Min<int64>(SparseRegions[SparseRegionIndex].Offset, Size) : Size;
+	return FMath::Max<int64>(HoleEnd - Position, 0);
 }
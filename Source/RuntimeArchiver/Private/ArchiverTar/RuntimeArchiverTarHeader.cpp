@@ -7,6 +7,7 @@
 #include "HAL/UnrealMemory.h"
 #include "Containers/StringConv.h"
 #include "ArchiverTar/RuntimeArchiverTarOperations.h"
+#include "ArchiverTar/RuntimeArchiverTar.h"
 
 /**
  * Helper that handles type flags
@@ -20,8 +21,22 @@ class FTarTypeFlagHelper
 	/** Directory type flag */
 	static const ANSICHAR DirectoryTypeFlag;
 
-	/** Unsupported type flags */
+	/** GNU sparse file type flag */
+	static const ANSICHAR SparseTypeFlag;
+
+	/** Hard link type flag */
 	static const ANSICHAR HardLinkTypeFlag;
+
+	/** PAX extended header type flag */
+	static const ANSICHAR PaxHeaderTypeFlag;
+
+	/** GNU volume header type flag */
+	static const ANSICHAR VolumeHeaderTypeFlag;
+
+	/** GNU multi-volume continuation type flag */
+	static const ANSICHAR ContinuationTypeFlag;
+
+	/** Unsupported type flags */
 	static const ANSICHAR SymbolicLinkTypeFlag;
 	static const ANSICHAR CharacterDeviceTypeFlag;
 	static const ANSICHAR BlockDeviceTypeFlag;
@@ -51,7 +66,7 @@ public:
 	 */
 	static bool IsDirectory(ANSICHAR TypeFlag)
 	{
-		if (TypeFlag == FileTypeFlag || TypeFlag == FileTypeFlag1)
+		if (TypeFlag == FileTypeFlag || TypeFlag == FileTypeFlag1 || TypeFlag == SparseTypeFlag || TypeFlag == HardLinkTypeFlag)
 		{
 			return false;
 		}
@@ -61,9 +76,11 @@ public:
 			return true;
 		}
 
-		UE_LOG(LogRuntimeArchiver, Error, TEXT("The type flag %c (%s) is not supported. Supported type flags are %c/%c (%s) and %c (%s)"),
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("The type flag %c (%s) is not supported. Supported type flags are %c/%c (%s), %c (%s), %c (%s) and %c (%s)"),
 		       TCHAR(TypeFlag), *ToString(TypeFlag),
 		       TCHAR(FileTypeFlag), TCHAR(FileTypeFlag1), *ToString(FileTypeFlag),
+		       TCHAR(SparseTypeFlag), *ToString(SparseTypeFlag),
+		       TCHAR(HardLinkTypeFlag), *ToString(HardLinkTypeFlag),
 		       TCHAR(DirectoryTypeFlag), *ToString(DirectoryTypeFlag));
 		return false;
 	}
@@ -75,12 +92,88 @@ public:
 	{
 		return bIsDirectory ? DirectoryTypeFlag : FileTypeFlag;
 	}
+
+	/**
+	 * Check if the specified type flag applies to a sparse file
+	 */
+	static bool IsSparse(ANSICHAR TypeFlag)
+	{
+		return TypeFlag == SparseTypeFlag;
+	}
+
+	/**
+	 * Get sparse file type flag
+	 */
+	static ANSICHAR GetSparseTypeFlag()
+	{
+		return SparseTypeFlag;
+	}
+
+	/**
+	 * Check if the specified type flag applies to a hard link
+	 */
+	static bool IsHardLink(ANSICHAR TypeFlag)
+	{
+		return TypeFlag == HardLinkTypeFlag;
+	}
+
+	/**
+	 * Get hard link type flag
+	 */
+	static ANSICHAR GetHardLinkTypeFlag()
+	{
+		return HardLinkTypeFlag;
+	}
+
+	/**
+	 * Check if the specified type flag applies to a PAX extended header
+	 */
+	static bool IsPaxHeader(ANSICHAR TypeFlag)
+	{
+		return TypeFlag == PaxHeaderTypeFlag;
+	}
+
+	/**
+	 * Get PAX extended header type flag
+	 */
+	static ANSICHAR GetPaxHeaderTypeFlag()
+	{
+		return PaxHeaderTypeFlag;
+	}
+
+	/**
+	 * Check if the specified type flag applies to a GNU volume or continuation header
+	 */
+	static bool IsVolumeBoundary(ANSICHAR TypeFlag)
+	{
+		return TypeFlag == VolumeHeaderTypeFlag || TypeFlag == ContinuationTypeFlag;
+	}
+
+	/**
+	 * Get GNU volume header type flag
+	 */
+	static ANSICHAR GetVolumeHeaderTypeFlag()
+	{
+		return VolumeHeaderTypeFlag;
+	}
+
+	/**
+	 * Get GNU multi-volume continuation type flag
+	 */
+	static ANSICHAR GetContinuationTypeFlag()
+	{
+		return ContinuationTypeFlag;
+	}
 };
 
 const ANSICHAR FTarTypeFlagHelper::FileTypeFlag{'0'};
 const ANSICHAR FTarTypeFlagHelper::FileTypeFlag1{'\0'};
 const ANSICHAR FTarTypeFlagHelper::DirectoryTypeFlag{'5'};
+const ANSICHAR FTarTypeFlagHelper::SparseTypeFlag{'S'};
 const ANSICHAR FTarTypeFlagHelper::HardLinkTypeFlag{'1'};
+const ANSICHAR FTarTypeFlagHelper::PaxHeaderTypeFlag{'x'};
+const ANSICHAR FTarTypeFlagHelper::VolumeHeaderTypeFlag{'V'};
+const ANSICHAR FTarTypeFlagHelper::ContinuationTypeFlag{'M'};
 const ANSICHAR FTarTypeFlagHelper::SymbolicLinkTypeFlag{'2'};
 const ANSICHAR FTarTypeFlagHelper::CharacterDeviceTypeFlag{'3'};
 const ANSICHAR FTarTypeFlagHelper::BlockDeviceTypeFlag{'4'};
@@ -89,13 +182,20 @@ const ANSICHAR FTarTypeFlagHelper::FIFOTypeFlag{'6'};
 const TMap<ANSICHAR, FString> FTarTypeFlagHelper::Strings{
 	{FileTypeFlag, TEXT("File")}, {FileTypeFlag1, TEXT("File")},
 	{DirectoryTypeFlag, TEXT("Directory")},
+	{SparseTypeFlag, TEXT("Sparse file")},
 	{HardLinkTypeFlag, TEXT("Hard link")},
+	{PaxHeaderTypeFlag, TEXT("PAX extended header")},
+	{VolumeHeaderTypeFlag, TEXT("Volume header")},
+	{ContinuationTypeFlag, TEXT("Multi-volume continuation")},
 	{SymbolicLinkTypeFlag, TEXT("Symbolic link")},
 	{CharacterDeviceTypeFlag, TEXT("Character device")},
 	{BlockDeviceTypeFlag, TEXT("Block device")},
 	{FIFOTypeFlag, TEXT("FIFO")}
 };
 
+/** Name of the headers that vacate the regions of removed entries */
+static const ANSICHAR* const VacatedEntryName{"././@Vacated"};
+
 /**
  * Helper that handles checksum
  */
@@ -135,22 +235,75 @@ public:
 	{
 		const uint8* HeaderPtr = reinterpret_cast<const uint8*>(&Header);
 
-		uint32 Checksum = 256;
+		// The checksum field itself is treated as if it were filled with spaces
+		uint32 Checksum = RuntimeArchiverTarOperations::SumBytes(HeaderPtr, sizeof(FTarHeader)) + UE_ARRAY_COUNT(Header.Checksum) * ' ';
 
-		for (size_t Index = 0; Index < STRUCT_OFFSET(FTarHeader, Checksum); ++Index)
+		for (size_t Index = STRUCT_OFFSET(FTarHeader, Checksum); Index < STRUCT_OFFSET(FTarHeader, TypeFlag); ++Index)
 		{
-			Checksum += HeaderPtr[Index];
+			Checksum -= HeaderPtr[Index];
 		}
 
-		for (size_t Index = STRUCT_OFFSET(FTarHeader, TypeFlag); Index < sizeof(Header); ++Index)
+		return Checksum;
+	}
+};
+
+/**
+ * Helper that handles sparse maps
+ */
+class FTarSparseMapHelper
+{
+public:
+	/**
+	 * Append the regions stored in the specified fields. Unused fields are left empty and end the map
+	 *
+	 * @param Fields Fields to read the regions from
+	 * @param NumOfFields Number of fields
+	 * @param Regions Regions to append to
+	 */
+	static void ReadRegions(const FTarSparseRegionField* Fields, int32 NumOfFields, TArray<FRuntimeArchiverTarSparseRegion>& Regions)
+	{
+		for (int32 Index = 0; Index < NumOfFields && Fields[Index].Offset[0] != '\0'; ++Index)
 		{
-			Checksum += HeaderPtr[Index];
+			Regions.Add(FRuntimeArchiverTarSparseRegion{
+				RuntimeArchiverTarOperations::NumericToDecimal<int64>(Fields[Index].Offset, UE_ARRAY_COUNT(Fields[Index].Offset)),
+				RuntimeArchiverTarOperations::NumericToDecimal<int64>(Fields[Index].NumBytes, UE_ARRAY_COUNT(Fields[Index].NumBytes))
+			});
 		}
+	}
 
-		return Checksum;
+	/**
+	 * Store as many regions as fit into the specified fields, starting from the specified region
+	 *
+	 * @param Regions Regions to store
+	 * @param RegionIndex Index of the first region to store. Advanced past the stored regions
+	 * @param Fields Fields to store the regions in
+	 * @param NumOfFields Number of fields
+	 */
+	static void WriteRegions(const TArray<FRuntimeArchiverTarSparseRegion>& Regions, int32& RegionIndex, FTarSparseRegionField* Fields, int32 NumOfFields)
+	{
+		for (int32 Index = 0; Index < NumOfFields && RegionIndex < Regions.Num(); ++Index, ++RegionIndex)
+		{
+			RuntimeArchiverTarOperations::DecimalToNumeric<int64>(Regions[RegionIndex].Offset, Fields[Index].Offset, UE_ARRAY_COUNT(Fields[Index].Offset));
+			RuntimeArchiverTarOperations::DecimalToNumeric<int64>(Regions[RegionIndex].Size, Fields[Index].NumBytes, UE_ARRAY_COUNT(Fields[Index].NumBytes));
+		}
 	}
 };
 
+FTarSparseHeader::FTarSparseHeader()
+{
+	FMemory::Memset(this, 0, sizeof(FTarSparseHeader));
+}
+
+void FTarSparseHeader::GetSparseRegions(TArray<FRuntimeArchiverTarSparseRegion>& Regions) const
+{
+	FTarSparseMapHelper::ReadRegions(Sparse, UE_ARRAY_COUNT(Sparse), Regions);
+}
+
+bool FTarSparseHeader::IsExtendedHeader() const
+{
+	return IsExtended != 0;
+}
+
 FTarHeader::FTarHeader()
 {
 	FMemory::Memset(this, 0, sizeof(FTarHeader));
@@ -166,8 +319,8 @@ bool FTarHeader::ToEntry(const FTarHeader& Header, int32 Index, FRuntimeArchiveE
 	Entry.Index = Index;
 	Entry.Name = StringCast<TCHAR>(Header.GetName()).Get();
 	Entry.bIsDirectory = FTarTypeFlagHelper::IsDirectory(Header.GetTypeFlag());
-	Entry.UncompressedSize = Header.GetSize();
-	Entry.CompressedSize = RuntimeArchiverTarOperations::RoundUp<int64>(Entry.UncompressedSize, 512);
+	Entry.UncompressedSize = Header.GetRealSize();
+	Entry.CompressedSize = RuntimeArchiverTarOperations::RoundUp<int64>(Header.GetSize(), 512);
 	Entry.CreationTime = FDateTime::FromUnixTimestamp(Header.GetTime());
 
 	return true;
@@ -198,6 +351,173 @@ bool FTarHeader::GenerateHeader(const FString& Name, int64 Size, const FDateTime
 	return true;
 }
 
+bool FTarHeader::GenerateSparseHeader(const FString& Name, int64 RealSize, const TArray<FRuntimeArchiverTarSparseRegion>& Regions, const FDateTime& CreationTime, FTarHeader& Header, TArray<FTarSparseHeader>& ExtensionHeaders)
+{
+	// Only the regions are stored, one after another
+	int64 StoredSize = 0;
+	for (const FRuntimeArchiverTarSparseRegion& Region : Regions)
+	{
+		StoredSize += Region.Size;
+	}
+
+	if (!GenerateHeader(Name, StoredSize, CreationTime, false, Header))
+	{
+		return false;
+	}
+
+	// The sparse fields are only recognized in the GNU format
+	FMemory::Memcpy(Header.Magic, "ustar ", UE_ARRAY_COUNT(Header.Magic));
+	FMemory::Memcpy(Header.Version, " ", UE_ARRAY_COUNT(Header.Version));
+
+	Header.SetTypeFlag(FTarTypeFlagHelper::GetSparseTypeFlag());
+	RuntimeArchiverTarOperations::DecimalToNumeric<int64>(RealSize, Header.RealSize, UE_ARRAY_COUNT(Header.RealSize));
+
+	int32 RegionIndex = 0;
+	FTarSparseMapHelper::WriteRegions(Regions, RegionIndex, Header.Sparse, UE_ARRAY_COUNT(Header.Sparse));
+
+	ExtensionHeaders.Reset();
+
+	// The regions that do not fit into the header are stored in a chain of extension headers
+	while (RegionIndex < Regions.Num())
+	{
+		(ExtensionHeaders.Num() > 0 ? ExtensionHeaders.Last().IsExtended : Header.IsExtended) = 1;
+
+		FTarSparseHeader& ExtensionHeader = ExtensionHeaders.AddDefaulted_GetRef();
+		FTarSparseMapHelper::WriteRegions(Regions, RegionIndex, ExtensionHeader.Sparse, UE_ARRAY_COUNT(ExtensionHeader.Sparse));
+	}
+
+	Header.SetChecksum(FTarChecksumHelper::BuildChecksum(Header));
+
+	return true;
+}
+
+bool FTarHeader::GenerateHardLinkHeader(const FString& Name, const FString& TargetName, const FDateTime& CreationTime, FTarHeader& Header)
+{
+	if (!GenerateHeader(Name, 0, CreationTime, false, Header))
+	{
+		return false;
+	}
+
+	// The link name is stored in the same encoding as the entry name
+	if (!Header.SetLinkName(reinterpret_cast<const ANSICHAR*>(StringCast<RA_UTF8CHAR>(*TargetName).Get())))
+	{
+		return false;
+	}
+
+	Header.SetTypeFlag(FTarTypeFlagHelper::GetHardLinkTypeFlag());
+	Header.SetChecksum(FTarChecksumHelper::BuildChecksum(Header));
+
+	return true;
+}
+
+bool FTarHeader::GenerateVacatedHeader(int64 Size, FTarHeader& Header)
+{
+	if (!GenerateHeader(VacatedEntryName, Size, FDateTime::FromUnixTimestamp(0), false, Header))
+	{
+		return false;
+	}
+
+	// Extended headers belong to the POSIX format
+	FMemory::Memcpy(Header.Magic, "ustar", UE_ARRAY_COUNT(Header.Magic));
+	FMemory::Memcpy(Header.Version, "00", UE_ARRAY_COUNT(Header.Version));
+
+	Header.SetTypeFlag(FTarTypeFlagHelper::GetPaxHeaderTypeFlag());
+	Header.SetChecksum(FTarChecksumHelper::BuildChecksum(Header));
+
+	return true;
+}
+
+bool FTarHeader::GenerateVolumeHeader(const FString& Label, const FDateTime& CreationTime, FTarHeader& Header)
+{
+	if (!GenerateHeader(Label, 0, CreationTime, false, Header))
+	{
+		return false;
+	}
+
+	// Multi-volume archives are a GNU extension
+	FMemory::Memcpy(Header.Magic, "ustar ", UE_ARRAY_COUNT(Header.Magic));
+	FMemory::Memcpy(Header.Version, " ", UE_ARRAY_COUNT(Header.Version));
+
+	Header.SetTypeFlag(FTarTypeFlagHelper::GetVolumeHeaderTypeFlag());
+	Header.SetChecksum(FTarChecksumHelper::BuildChecksum(Header));
+
+	return true;
+}
+
+bool FTarHeader::GenerateContinuationHeader(const FString& Name, int64 RealSize, int64 Offset, const FDateTime& CreationTime, FTarHeader& Header)
+{
+	// The size is the part of the data stored from this volume on, while the offset locates it in the entry data
+	if (!GenerateHeader(Name, RealSize - Offset, CreationTime, false, Header))
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(Header.Magic, "ustar ", UE_ARRAY_COUNT(Header.Magic));
+	FMemory::Memcpy(Header.Version, " ", UE_ARRAY_COUNT(Header.Version));
+
+	Header.SetTypeFlag(FTarTypeFlagHelper::GetContinuationTypeFlag());
+	RuntimeArchiverTarOperations::DecimalToNumeric<int64>(Offset, Header.Offset, UE_ARRAY_COUNT(Header.Offset));
+	RuntimeArchiverTarOperations::DecimalToNumeric<int64>(RealSize, Header.RealSize, UE_ARRAY_COUNT(Header.RealSize));
+	Header.SetChecksum(FTarChecksumHelper::BuildChecksum(Header));
+
+	return true;
+}
+
+bool FTarHeader::IsChecksumValid() const
+{
+	return FTarChecksumHelper::IsValid(*this);
+}
+
+bool FTarHeader::IsVolumeBoundary() const
+{
+	// GNU tar leaves the format magic of continuation headers empty, so the checksum is what tells them apart from the entry data
+	return FTarTypeFlagHelper::IsVolumeBoundary(TypeFlag) && FTarChecksumHelper::BuildChecksum(*this) == GetChecksum();
+}
+
+bool FTarHeader::IsVacated() const
+{
+	return FTarTypeFlagHelper::IsPaxHeader(TypeFlag) && FCStringAnsi::Strncmp(reinterpret_cast<const ANSICHAR*>(Name), VacatedEntryName, UE_ARRAY_COUNT(Name)) == 0;
+}
+
+bool FTarHeader::IsHardLink() const
+{
+	return FTarTypeFlagHelper::IsHardLink(TypeFlag);
+}
+
+FString FTarHeader::GetLinkTargetName() const
+{
+	return StringCast<TCHAR>(reinterpret_cast<const RA_UTF8CHAR*>(LinkName)).Get();
+}
+
+bool FTarHeader::IsSparse() const
+{
+	return FTarTypeFlagHelper::IsSparse(TypeFlag);
+}
+
+bool FTarHeader::IsExtendedHeader() const
+{
+	return IsSparse() && IsExtended != 0;
+}
+
+int64 FTarHeader::GetRealSize() const
+{
+	return IsSparse() ? RuntimeArchiverTarOperations::NumericToDecimal<int64>(RealSize, UE_ARRAY_COUNT(RealSize)) : GetSize();
+}
+
+void FTarHeader::GetSparseRegions(TArray<FRuntimeArchiverTarSparseRegion>& Regions) const
+{
+	if (IsSparse())
+	{
+		FTarSparseMapHelper::ReadRegions(Sparse, UE_ARRAY_COUNT(Sparse), Regions);
+	}
+}
+
+void FTarHeader::Resize(int64 InSize)
+{
+	SetSize(InSize);
+	SetChecksum(FTarChecksumHelper::BuildChecksum(*this));
+}
+
 const RA_UTF8CHAR* FTarHeader::GetName() const
 {
 	return Name;
@@ -217,7 +537,7 @@ bool FTarHeader::SetName(const RA_UTF8CHAR* InName)
 
 uint32 FTarHeader::GetMode() const
 {
-	return RuntimeArchiverTarOperations::OctalToDecimal<uint32>(Mode);
+	return RuntimeArchiverTarOperations::OctalToDecimal<uint32>(Mode, UE_ARRAY_COUNT(Mode));
 }
 
 void FTarHeader::SetMode(uint32 InMode)
@@ -227,7 +547,7 @@ void FTarHeader::SetMode(uint32 InMode)
 
 uint32 FTarHeader::GetOwner() const
 {
-	return RuntimeArchiverTarOperations::OctalToDecimal<uint32>(Owner);
+	return RuntimeArchiverTarOperations::OctalToDecimal<uint32>(Owner, UE_ARRAY_COUNT(Owner));
 }
 
 void FTarHeader::SetOwner(uint32 InOwner)
@@ -254,27 +574,27 @@ bool FTarHeader::SetGroup(const ANSICHAR* InGroup)
 
 int64 FTarHeader::GetSize() const
 {
-	return RuntimeArchiverTarOperations::OctalToDecimal<int64>(Size);
+	return RuntimeArchiverTarOperations::NumericToDecimal<int64>(Size, UE_ARRAY_COUNT(Size));
 }
 
 void FTarHeader::SetSize(int64 InSize)
 {
-	RuntimeArchiverTarOperations::DecimalToOctal<int64>(InSize, Size, UE_ARRAY_COUNT(Size));
+	RuntimeArchiverTarOperations::DecimalToNumeric<int64>(InSize, Size, UE_ARRAY_COUNT(Size));
 }
 
 int64 FTarHeader::GetTime() const
 {
-	return RuntimeArchiverTarOperations::OctalToDecimal<int64>(Time);
+	return RuntimeArchiverTarOperations::NumericToDecimal<int64>(Time, UE_ARRAY_COUNT(Time));
 }
 
 void FTarHeader::SetTime(int64 InTime)
 {
-	RuntimeArchiverTarOperations::DecimalToOctal<int64>(InTime, Time, UE_ARRAY_COUNT(Time));
+	RuntimeArchiverTarOperations::DecimalToNumeric<int64>(InTime, Time, UE_ARRAY_COUNT(Time));
 }
 
 uint32 FTarHeader::GetChecksum() const
 {
-	return RuntimeArchiverTarOperations::OctalToDecimal<uint32>(Checksum);
+	return RuntimeArchiverTarOperations::OctalToDecimal<uint32>(Checksum, UE_ARRAY_COUNT(Checksum));
 }
 
 void FTarHeader::SetChecksum(uint32 InChecksum)
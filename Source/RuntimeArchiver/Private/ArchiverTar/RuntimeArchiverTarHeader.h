@@ -15,6 +15,52 @@ using RA_UTF8CHAR = UTF8CHAR;
 
 class FTarChecksumHelper;
 struct FRuntimeArchiveEntry;
+struct FRuntimeArchiverTarSparseRegion;
+
+/**
+ * Sparse region as stored in the GNU tar headers
+ */
+struct FTarSparseRegionField
+{
+	/** Offset of the region in the entry content */
+	ANSICHAR Offset[12];
+
+	/** Region size */
+	ANSICHAR NumBytes[12];
+};
+
+/**
+ * Extension header that follows a GNU sparse header when the sparse map does not fit into it
+ */
+struct FTarSparseHeader
+{
+	FTarSparseHeader();
+
+private:
+	/** Sparse regions */
+	FTarSparseRegionField Sparse[21];
+
+	/** Whether the sparse map continues in the next extension header */
+	ANSICHAR IsExtended;
+
+	/** Unused padding */
+	ANSICHAR Padding[7];
+
+public:
+	/**
+	 * Append the sparse regions stored in the header
+	 *
+	 * @param Regions Regions to append to
+	 */
+	void GetSparseRegions(TArray<FRuntimeArchiverTarSparseRegion>& Regions) const;
+
+	/**
+	 * Whether another extension header follows
+	 */
+	bool IsExtendedHeader() const;
+
+	friend struct FTarHeader;
+};
 
 /**
  * Tar header used to denote archived data 
@@ -53,10 +99,50 @@ private:
 	/** Name of target file name. Not used, but denotes some rarely used entry types */
 	ANSICHAR LinkName[100];
 
-	/** Unused padding */
-	ANSICHAR Padding[255];
+	/** Format magic. "ustar " for the GNU format, empty for the original Unix format */
+	ANSICHAR Magic[6];
+
+	/** Format version. " " for the GNU format */
+	ANSICHAR Version[2];
 
-	// TODO: Replace Padding with additional fields (Magic, Version, UName, GName, DevMajor, DevMinor, Prefix) for better compatibility
+	/** Owner user name */
+	ANSICHAR UName[32];
+
+	/** Owner group name */
+	ANSICHAR GName[32];
+
+	/** Device major number */
+	ANSICHAR DevMajor[8];
+
+	/** Device minor number */
+	ANSICHAR DevMinor[8];
+
+	/** Time of last access */
+	ANSICHAR ATime[12];
+
+	/** Time of creation */
+	ANSICHAR CTime[12];
+
+	/** Offset of the multi-volume continuation */
+	ANSICHAR Offset[12];
+
+	/** Unused long names field */
+	ANSICHAR LongNames[4];
+
+	/** Unused */
+	ANSICHAR Unused;
+
+	/** First sparse regions of a sparse entry. The rest are stored in the extension headers */
+	FTarSparseRegionField Sparse[4];
+
+	/** Whether the sparse map continues in an extension header */
+	ANSICHAR IsExtended;
+
+	/** Size of a sparse entry, including the holes */
+	ANSICHAR RealSize[12];
+
+	/** Unused padding */
+	ANSICHAR Padding[17];
 
 public:
 	/**
@@ -90,6 +176,115 @@ public:
 	 */
 	static bool GenerateHeader(const FString& Name, int64 Size, const FDateTime& CreationTime, bool bIsDirectory, FTarHeader& Header);
 
+	/**
+	 * Generate GNU sparse tar header based on input. Only the regions are stored in the archive, the rest of the content is zeros
+	 *
+	 * @param Name Entry name
+	 * @param RealSize Entry content size, including the holes
+	 * @param Regions Regions of the content that contain data, in ascending order
+	 * @param CreationTime Entry creation time
+	 * @param Header Filled tar header
+	 * @param ExtensionHeaders Filled extension headers that must be written right after the header. Empty if all regions fit into the header
+	 * @return Whether the conversion was successful or not
+	 */
+	static bool GenerateSparseHeader(const FString& Name, int64 RealSize, const TArray<FRuntimeArchiverTarSparseRegion>& Regions, const FDateTime& CreationTime, FTarHeader& Header, TArray<FTarSparseHeader>& ExtensionHeaders);
+
+	/**
+	 * Generate hard link tar header based on input. The entry has no data of its own and refers to the data of an earlier entry
+	 *
+	 * @param Name Entry name
+	 * @param TargetName Name of the earlier entry the link points to
+	 * @param CreationTime Entry creation time
+	 * @param Header Filled tar header
+	 * @return Whether the conversion was successful or not
+	 */
+	static bool GenerateHardLinkHeader(const FString& Name, const FString& TargetName, const FDateTime& CreationTime, FTarHeader& Header);
+
+	/**
+	 * Generate tar header that vacates the region of a removed entry. The header is a PAX extended header whose data is a single comment record, so readers skip the region without extracting anything
+	 *
+	 * @param Size Size of the vacated region following the header
+	 * @param Header Filled tar header
+	 * @return Whether the conversion was successful or not
+	 */
+	static bool GenerateVacatedHeader(int64 Size, FTarHeader& Header);
+
+	/**
+	 * Generate GNU volume header based on input. The header labels a volume of a multi-volume archive and has no data
+	 *
+	 * @param Label Volume label
+	 * @param CreationTime Volume creation time
+	 * @param Header Filled tar header
+	 * @return Whether the conversion was successful or not
+	 */
+	static bool GenerateVolumeHeader(const FString& Label, const FDateTime& CreationTime, FTarHeader& Header);
+
+	/**
+	 * Generate GNU continuation header based on input. The header starts a volume of a multi-volume archive when an entry does not fit into the previous volume
+	 *
+	 * @param Name Name of the continued entry
+	 * @param RealSize Size of the continued entry data
+	 * @param Offset Size of the entry data already stored in the previous volumes
+	 * @param CreationTime Entry creation time
+	 * @param Header Filled tar header
+	 * @return Whether the conversion was successful or not
+	 */
+	static bool GenerateContinuationHeader(const FString& Name, int64 RealSize, int64 Offset, const FDateTime& CreationTime, FTarHeader& Header);
+
+	/**
+	 * Whether the checksum stored in the header matches the header contents
+	 */
+	bool IsChecksumValid() const;
+
+	/**
+	 * Whether the header is a GNU volume or continuation header. Such headers only appear at the start of the volumes of a multi-volume archive
+	 */
+	bool IsVolumeBoundary() const;
+
+	/**
+	 * Whether the header vacates the region of a removed entry
+	 */
+	bool IsVacated() const;
+
+	/**
+	 * Whether the header denotes a hard link entry
+	 */
+	bool IsHardLink() const;
+
+	/**
+	 * Get the name of the entry the hard link points to
+	 */
+	FString GetLinkTargetName() const;
+
+	/**
+	 * Whether the header denotes a GNU sparse entry
+	 */
+	bool IsSparse() const;
+
+	/**
+	 * Whether an extension header with the rest of the sparse map follows
+	 */
+	bool IsExtendedHeader() const;
+
+	/**
+	 * Get the entry content size. For sparse entries, this includes the holes, while GetSize only returns the size of the stored regions
+	 */
+	int64 GetRealSize() const;
+
+	/**
+	 * Append the sparse regions stored in the header
+	 *
+	 * @param Regions Regions to append to
+	 */
+	void GetSparseRegions(TArray<FRuntimeArchiverTarSparseRegion>& Regions) const;
+
+	/**
+	 * Change the data size of an already generated header and rebuild its checksum
+	 *
+	 * @param InSize New data size
+	 */
+	void Resize(int64 InSize);
+
 	//~ Writing and reading tar header data
 
 	const RA_UTF8CHAR* GetName() const;
@@ -119,3 +314,6 @@ public:
 	const ANSICHAR* GetLinkName() const;
 	bool SetLinkName(const ANSICHAR* InLinkName);
 };
+
+static_assert(sizeof(FTarHeader) == 512, "Tar header must occupy exactly one block");
+static_assert(sizeof(FTarSparseHeader) == 512, "Tar sparse extension header must occupy exactly one block");
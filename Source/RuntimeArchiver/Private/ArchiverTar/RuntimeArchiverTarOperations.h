@@ -2,8 +2,17 @@
 
 #pragma once
 
-#include <string>
-#include "Misc/CString.h"
+#include "CoreTypes.h"
+#include "Templates/EnableIf.h"
+#include "Templates/IsIntegral.h"
+
+#if defined(PLATFORM_CPU_X86_FAMILY) && PLATFORM_CPU_X86_FAMILY && defined(PLATFORM_ENABLE_VECTORINTRINSICS) && PLATFORM_ENABLE_VECTORINTRINSICS
+#include <emmintrin.h>
+#define RUNTIMEARCHIVER_TAR_SSE2 1
+#elif defined(PLATFORM_ENABLE_VECTORINTRINSICS_NEON) && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#define RUNTIMEARCHIVER_TAR_NEON 1
+#endif
 
 /**
  * Common functions that are used in tar operations
@@ -22,57 +31,160 @@ namespace RuntimeArchiverTarOperations
 	}
 
 	/**
-	 * Convert string containing octal number to decimal number
-	 * This overload is for int32
+	 * Convert a fixed-width field containing an octal number to a decimal number
+	 * Leading spaces are skipped and parsing stops at the first non-octal character (usually a null character or a space) or at the end of the field
 	 */
 	template <typename DecimalType, typename CharType>
-	typename TEnableIf<TIsSame<DecimalType, int32>::Value, DecimalType>::Type
-	OctalToDecimal(const CharType* OctalString)
+	typename TEnableIf<TIsIntegral<DecimalType>::Value, DecimalType>::Type
+	OctalToDecimal(const CharType* OctalString, int32 MaxLength)
 	{
-		return std::stoi(OctalString, 0, 8);
+		int32 Index = 0;
+
+		while (Index < MaxLength && OctalString[Index] == ' ')
+		{
+			++Index;
+		}
+
+		uint64 Decimal = 0;
+
+		for (; Index < MaxLength; ++Index)
+		{
+			const uint8 Digit = static_cast<uint8>(OctalString[Index] - '0');
+
+			if (Digit > 7)
+			{
+				break;
+			}
+
+			Decimal = (Decimal << 3) | Digit;
+		}
+
+		return static_cast<DecimalType>(Decimal);
 	}
 
 	/**
-	 * Convert string containing octal number to decimal number
-	 * This overload is for int64
+	 * Convert a fixed-width numeric field to a decimal number
+	 * Supports both octal numbers and the GNU base-256 encoding used for values that do not fit into the octal representation (e.g. sizes of 8 GiB and above)
 	 */
 	template <typename DecimalType, typename CharType>
-	typename TEnableIf<TIsSame<DecimalType, int64>::Value, DecimalType>::Type
-	OctalToDecimal(const CharType* OctalString)
+	typename TEnableIf<TIsIntegral<DecimalType>::Value, DecimalType>::Type
+	NumericToDecimal(const CharType* NumericString, int32 MaxLength)
 	{
-		return std::stoll(OctalString, 0, 8);
+		const uint8 LeadingByte = static_cast<uint8>(NumericString[0]);
+
+		// The highest bit of the leading byte denotes base-256 encoding. The remaining bytes are a big-endian two's complement number
+		if (LeadingByte & 0x80)
+		{
+			uint64 Decimal = LeadingByte == 0xFF ? ~static_cast<uint64>(0) : 0;
+
+			for (int32 Index = 1; Index < MaxLength; ++Index)
+			{
+				Decimal = (Decimal << 8) | static_cast<uint8>(NumericString[Index]);
+			}
+
+			return static_cast<DecimalType>(Decimal);
+		}
+
+		return OctalToDecimal<DecimalType>(NumericString, MaxLength);
 	}
 
 	/**
-	 * Convert string containing octal number to decimal number
-	 * This overload is for uint32
+	 * Convert a decimal number to a fixed-width field containing a zero-padded octal number terminated by a null character
+	 *
+	 * @return Whether the number fits into the field or not. The field is left unchanged if it does not fit. Negative numbers never fit, as they convert to values above the field range
 	 */
 	template <typename DecimalType, typename CharType>
-	typename TEnableIf<TIsSame<DecimalType, uint32>::Value, DecimalType>::Type
-	OctalToDecimal(const CharType* OctalString)
+	typename TEnableIf<TIsIntegral<DecimalType>::Value, bool>::Type
+	DecimalToOctal(DecimalType Decimal, CharType* Octal, int32 MaxLength)
 	{
-		return std::stoul(OctalString, 0, 8);
+		const int32 NumOfDigits = MaxLength - 1;
+		uint64 Remaining = static_cast<uint64>(Decimal);
+
+		// Each octal digit holds 3 bits
+		if (NumOfDigits * 3 < 64 && (Remaining >> (NumOfDigits * 3)) != 0)
+		{
+			return false;
+		}
+
+		for (int32 Index = NumOfDigits - 1; Index >= 0; --Index)
+		{
+			Octal[Index] = static_cast<CharType>('0' + (Remaining & 7));
+			Remaining >>= 3;
+		}
+
+		Octal[NumOfDigits] = '\0';
+
+		return true;
 	}
 
 	/**
-	 * Convert decimal number to string containing octal number
-	 * This overload is for int32
+	 * Convert a decimal number to a fixed-width numeric field
+	 * Uses the octal representation when possible and falls back to the GNU base-256 encoding for values that do not fit or are negative
 	 */
-	template<typename DecimalType, typename CharType>
-	typename TEnableIf<TIsSame<DecimalType, int64>::Value>::Type
-	DecimalToOctal(DecimalType Decimal, CharType* Octal, int32 MaxLength)
+	template <typename DecimalType, typename CharType>
+	typename TEnableIf<TIsIntegral<DecimalType>::Value>::Type
+	DecimalToNumeric(DecimalType Decimal, CharType* Numeric, int32 MaxLength)
 	{
-		TCString<CharType>::Sprintf(Octal, "%0*llo", MaxLength-1, Decimal);
+		if (DecimalToOctal<DecimalType>(Decimal, Numeric, MaxLength))
+		{
+			return;
+		}
+
+		int64 Remaining = static_cast<int64>(Decimal);
+
+		for (int32 Index = MaxLength - 1; Index > 0; --Index)
+		{
+			Numeric[Index] = static_cast<CharType>(Remaining & 0xFF);
+			Remaining >>= 8;
+		}
+
+		Numeric[0] = static_cast<CharType>(Decimal < 0 ? 0xFF : 0x80);
 	}
 
 	/**
-	 * Convert decimal number to string containing octal number
-	 * This overload is for int32
+	 * Sum all bytes of the specified data. Vectorized where possible
+	 *
+	 * @param Data Data to sum
+	 * @param Size Data size. At most 8 KiB to avoid overflowing the intermediate vector sums
+	 * @return Sum of all bytes
 	 */
-	template<typename DecimalType, typename CharType>
-	typename TEnableIf<TIsSame<DecimalType, uint32>::Value>::Type
-	DecimalToOctal(DecimalType Decimal, CharType* Octal, int32 MaxLength)
+	FORCEINLINE uint32 SumBytes(const uint8* Data, int32 Size)
 	{
-		TCString<CharType>::Sprintf(Octal, "%0*o", MaxLength-1, Decimal);
+		uint32 Sum = 0;
+		int32 Index = 0;
+
+#if defined(RUNTIMEARCHIVER_TAR_SSE2)
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			__m128i VectorSum = _mm_setzero_si128();
+
+			// Sum of absolute differences against zero adds up 8 bytes into each 64-bit lane
+			for (; Index + 16 <= Size; Index += 16)
+			{
+				VectorSum = _mm_add_epi64(VectorSum, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + Index)), Zero));
+			}
+
+			Sum += static_cast<uint32>(_mm_cvtsi128_si32(VectorSum)) + static_cast<uint32>(_mm_cvtsi128_si32(_mm_srli_si128(VectorSum, 8)));
+		}
+#elif defined(RUNTIMEARCHIVER_TAR_NEON)
+		{
+			uint32x4_t VectorSum = vdupq_n_u32(0);
+
+			// Pairwise widening additions of 16 bytes into four 32-bit lanes
+			for (; Index + 16 <= Size; Index += 16)
+			{
+				VectorSum = vpadalq_u16(VectorSum, vpaddlq_u8(vld1q_u8(Data + Index)));
+			}
+
+			Sum += vgetq_lane_u32(VectorSum, 0) + vgetq_lane_u32(VectorSum, 1) + vgetq_lane_u32(VectorSum, 2) + vgetq_lane_u32(VectorSum, 3);
+		}
+#endif
+
+		for (; Index < Size; ++Index)
+		{
+			Sum += Data[Index];
+		}
+
+		return Sum;
 	}
 }
@@ -0,0 +1,214 @@
+﻿// Georgy Treshchev 2024.
+
+#include "ArchiverTar/RuntimeArchiverTarScanner.h"
+
+#include "RuntimeArchiverDefines.h"
+#include "RuntimeArchiverTypes.h"
+#include "RuntimeArchiverTarOperations.h"
+#include "ArchiverTar/RuntimeArchiverTarHeader.h"
+
+FRuntimeArchiverTarScanner::FRuntimeArchiverTarScanner(FRuntimeArchiverBaseStream& InStream)
+	: Stream{InStream}
+  , EntryIndex{-1}
+  , HeaderOffset{-1}
+  , DataOffset{-1}
+  , RemainingDataSize{0}
+  , PaddingSize{0}
+  , RealSize{0}
+  , bIsFinished{false}
+  , bHasError{false}
+{
+}
+
+bool FRuntimeArchiverTarScanner::Next(FTarHeader& Header)
+{
+	if (bIsFinished)
+	{
+		return false;
+	}
+
+	// Skipping whatever is left of the current entry
+	if (!Skip(RemainingDataSize + PaddingSize))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to skip the data of tar entry at offset %lld"), HeaderOffset);
+		bIsFinished = bHasError = true;
+		return false;
+	}
+
+	RemainingDataSize = PaddingSize = 0;
+
+	for (;;)
+	{
+		HeaderOffset = Stream.Tell();
+
+		// Running out of data at a header boundary means the archive has no end-of-archive marker, which is tolerated
+		if (!Stream.Read(&Header, sizeof(FTarHeader)))
+		{
+			bIsFinished = true;
+			return false;
+		}
+
+		// An empty name denotes the zero block at the end of the archive
+		if (Header.GetName()[0] == 0)
+		{
+			bIsFinished = true;
+			return false;
+		}
+
+		if (!Header.IsChecksumValid())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Tar header at offset %lld has an invalid checksum"), HeaderOffset);
+			bIsFinished = bHasError = true;
+			return false;
+		}
+
+		if (!Header.IsVacated())
+		{
+			break;
+		}
+
+		// Regions of removed entries are skipped as if they were not there
+		if (!Skip(RuntimeArchiverTarOperations::RoundUp<int64>(Header.GetSize(), 512)))
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to skip the vacated region at offset %lld"), HeaderOffset);
+			bIsFinished = bHasError = true;
+			return false;
+		}
+	}
+
+	const int64 Size = Header.GetSize();
+
+	if (Size < 0)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Tar entry '%s' has an invalid size %lld"), StringCast<TCHAR>(Header.GetName()).Get(), Size);
+		bIsFinished = bHasError = true;
+		return false;
+	}
+
+	RealSize = Header.GetRealSize();
+	SparseRegions.Reset();
+
+	if (Header.IsSparse() && !ReadSparseMap(Header))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Tar entry '%s' has an invalid sparse map"), StringCast<TCHAR>(Header.GetName()).Get());
+		bIsFinished = bHasError = true;
+		return false;
+	}
+
+	++EntryIndex;
+	DataOffset = Stream.Tell();
+	RemainingDataSize = Size;
+	PaddingSize = RuntimeArchiverTarOperations::RoundUp<int64>(Size, 512) - Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverTarScanner::Next(FRuntimeArchiveEntry& Entry)
+{
+	FTarHeader Header;
+
+	if (!Next(Header))
+	{
+		return false;
+	}
+
+	if (!FTarHeader::ToEntry(Header, EntryIndex, Entry))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to convert tar header at offset %lld to entry"), HeaderOffset);
+		bIsFinished = bHasError = true;
+		return false;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarScanner::ReadData(void* Data, int64 Size)
+{
+	if (Size > RemainingDataSize)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read %lld bytes of tar entry data because only %lld bytes remain"), Size, RemainingDataSize);
+		return false;
+	}
+
+	if (!Stream.Read(Data, Size))
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read tar entry data at offset %lld"), Stream.Tell());
+		bIsFinished = bHasError = true;
+		return false;
+	}
+
+	RemainingDataSize -= Size;
+	return true;
+}
+
+bool FRuntimeArchiverTarScanner::Skip(int64 Size)
+{
+	if (Size <= 0)
+	{
+		return true;
+	}
+
+	if (Stream.IsSeekable())
+	{
+		return Stream.Seek(Stream.Tell() + Size);
+	}
+
+	if (DiscardBuffer.Num() == 0)
+	{
+		DiscardBuffer.SetNumUninitialized(64 * 1024);
+	}
+
+	while (Size > 0)
+	{
+		const int64 ChunkSize = FMath::Min<int64>(Size, DiscardBuffer.Num());
+
+		if (!Stream.Read(DiscardBuffer.GetData(), ChunkSize))
+		{
+			return false;
+		}
+
+		Size -= ChunkSize;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverTarScanner::ReadSparseMap(const FTarHeader& Header)
+{
+	if (RealSize < 0)
+	{
+		return false;
+	}
+
+	Header.GetSparseRegions(SparseRegions);
+
+	for (bool bIsExtended = Header.IsExtendedHeader(); bIsExtended;)
+	{
+		FTarSparseHeader ExtensionHeader;
+
+		if (!Stream.Read(&ExtensionHeader, sizeof(ExtensionHeader)))
+		{
+			return false;
+		}
+
+		ExtensionHeader.GetSparseRegions(SparseRegions);
+		bIsExtended = ExtensionHeader.IsExtendedHeader();
+	}
+
+	// The regions must be ordered, lie within the content and add up to the stored data size
+	int64 RegionEnd = 0;
+	int64 StoredSize = 0;
+
+	for (const FRuntimeArchiverTarSparseRegion& Region : SparseRegions)
+	{
+		if (Region.Offset < RegionEnd || Region.Size < 0 || Region.Offset + Region.Size > RealSize)
+		{
+			return false;
+		}
+
+		RegionEnd = Region.Offset + Region.Size;
+		StoredSize += Region.Size;
+	}
+
+	return StoredSize == Header.GetSize();
+}
@@ -5,10 +5,31 @@
 #include "RuntimeArchiverSubsystem.h"
 #include "RuntimeArchiverDefines.h"
 #include "RuntimeArchiverZipIncludes.h"
+#include "Streams/RuntimeArchiverFileStream.h"
+#include "Streams/RuntimeArchiverMappedFileStream.h"
 #include "Misc/Paths.h"
 
+namespace
+{
+	/**
+	 * Miniz read callback reading the archive from the stream passed as the opaque pointer
+	 */
+	size_t ReadFromArchiveStream(void* Opaque, mz_uint64 Offset, void* Data, size_t Size)
+	{
+		FRuntimeArchiverBaseStream* Stream = static_cast<FRuntimeArchiverBaseStream*>(Opaque);
+
+		if (!Stream->Seek(static_cast<int64>(Offset)) || !Stream->Read(Data, static_cast<int64>(Size)))
+		{
+			return 0;
+		}
+
+		return Size;
+	}
+}
+
 URuntimeArchiverZip::URuntimeArchiverZip()
 	: Super::URuntimeArchiverBase()
+  , bMemoryMapArchive(false)
   , bAppendMode(false)
   , MinizArchiver(nullptr)
 {
@@ -65,8 +86,30 @@ bool URuntimeArchiverZip::OpenArchiveFromStorage(FString ArchivePath)
 
 	FPaths::NormalizeFilename(ArchivePath);
 
+	if (bMemoryMapArchive)
+	{
+		ArchiveStream.Reset(new FRuntimeArchiverMappedFileStream(ArchivePath, FRuntimeArchiverFileStream::DefaultBufferSize));
+		if (!ArchiveStream->IsValid())
+		{
+			ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("Unable to open memory-mapped zip archive '%s' to read"), *ArchivePath));
+			Reset();
+			return false;
+		}
+
+		// Reading the archive through the stream
+		mz_zip_archive* ZipArchive = static_cast<mz_zip_archive*>(MinizArchiver);
+		ZipArchive->m_pRead = &ReadFromArchiveStream;
+		ZipArchive->m_pIO_opaque = ArchiveStream.Get();
+
+		if (!mz_zip_reader_init(ZipArchive, ArchiveStream->Size(), 0))
+		{
+			ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("An error occurred while opening zip archive '%s' to read"), *ArchivePath));
+			Reset();
+			return false;
+		}
+	}
 	// Reading the archive from the file path
-	if (!mz_zip_reader_init_file(static_cast<mz_zip_archive*>(MinizArchiver), TCHAR_TO_UTF8(*ArchivePath), 0))
+	else if (!mz_zip_reader_init_file(static_cast<mz_zip_archive*>(MinizArchiver), TCHAR_TO_UTF8(*ArchivePath), 0))
 	{
 		ReportError(ERuntimeArchiverErrorCode::NotInitialized, FString::Printf(TEXT("An error occurred while opening zip archive '%s' to read"), *ArchivePath));
 		Reset();
@@ -234,6 +277,7 @@ bool URuntimeArchiverZip::GetArchiveEntryInfoByIndex(int32 EntryIndex, FRuntimeA
 		EntryInfo.Index = static_cast<int32>(ArchiveFileStat.m_file_index);
 		EntryInfo.CompressedSize = static_cast<int64>(ArchiveFileStat.m_comp_size);
 		EntryInfo.UncompressedSize = static_cast<int64>(ArchiveFileStat.m_uncomp_size);
+		EntryInfo.Checksum = static_cast<int64>(ArchiveFileStat.m_crc32);
 #ifndef MINIZ_NO_TIME
 		EntryInfo.CreationTime = FDateTime::FromUnixTimestamp(ArchiveFileStat.m_time);
 #endif
@@ -345,6 +389,8 @@ void URuntimeArchiverZip::Reset()
 		MinizArchiver = nullptr;
 	}
 
+	ArchiveStream.Reset();
+
 	Super::Reset();
 
 	UE_LOG(LogRuntimeArchiver, Log, TEXT("Successfully uninitialized zip archiver '%s'"), *GetName());
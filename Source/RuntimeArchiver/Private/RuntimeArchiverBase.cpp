@@ -232,14 +232,7 @@ bool URuntimeArchiverBase::AddEntryFromStorage(FString EntryName, FString FilePa
 		return false;
 	}
 
-	TArray64<uint8> FileData;
-	if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
-	{
-		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to load file '%s' for entry '%s'"), *FilePath, *EntryName));
-		return false;
-	}
-
-	if (!AddEntryFromMemory(EntryName, FileData, CompressionLevel))
+	if (!AddFileEntryFromStorage(EntryName, FilePath, CompressionLevel))
 	{
 		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to add entry '%s' from file '%s'"), *EntryName, *FilePath);
 		return false;
@@ -250,6 +243,18 @@ bool URuntimeArchiverBase::AddEntryFromStorage(FString EntryName, FString FilePa
 	return true;
 }
 
+bool URuntimeArchiverBase::AddFileEntryFromStorage(const FString& EntryName, const FString& FilePath, ERuntimeArchiverCompressionLevel CompressionLevel)
+{
+	TArray64<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
+	{
+		ReportError(ERuntimeArchiverErrorCode::AddError, FString::Printf(TEXT("Unable to load file '%s' for entry '%s'"), *FilePath, *EntryName));
+		return false;
+	}
+
+	return AddEntryFromMemory(EntryName, FileData, CompressionLevel);
+}
+
 void URuntimeArchiverBase::AddEntriesFromStorage(const FRuntimeArchiverAsyncOperationResult& OnResult, const FRuntimeArchiverAsyncOperationProgress& OnProgress, TArray<FString> FilePaths, ERuntimeArchiverCompressionLevel CompressionLevel)
 {
 	if (!IsInitialized())
@@ -500,16 +505,8 @@ bool URuntimeArchiverBase::ExtractEntryToStorage(const FRuntimeArchiveEntry& Ent
 			UE_LOG(LogRuntimeArchiver, Warning, TEXT("File '%s' already exists. It will be overwritten"), *FilePath);
 		}
 
-		TArray64<uint8> EntryData;
-		if (!ExtractEntryToMemory(EntryInfo, EntryData))
+		if (!ExtractFileEntryToStorage(EntryInfo, FilePath))
 		{
-			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to extract the entry '%s' from archive to memory for file '%s'"), *EntryInfo.Name, *FilePath));
-			return false;
-		}
-
-		if (!FFileHelper::SaveArrayToFile(EntryData, *FilePath))
-		{
-			ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to save the entry '%s' from memory to file '%s'"), *EntryInfo.Name, *FilePath));
 			return false;
 		}
 
@@ -519,6 +516,24 @@ bool URuntimeArchiverBase::ExtractEntryToStorage(const FRuntimeArchiveEntry& Ent
 	return true;
 }
 
+bool URuntimeArchiverBase::ExtractFileEntryToStorage(const FRuntimeArchiveEntry& EntryInfo, const FString& FilePath)
+{
+	TArray64<uint8> EntryData;
+	if (!ExtractEntryToMemory(EntryInfo, EntryData))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to extract the entry '%s' from archive to memory for file '%s'"), *EntryInfo.Name, *FilePath));
+		return false;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(EntryData, *FilePath))
+	{
+		ReportError(ERuntimeArchiverErrorCode::ExtractError, FString::Printf(TEXT("Unable to save the entry '%s' from memory to file '%s'"), *EntryInfo.Name, *FilePath));
+		return false;
+	}
+
+	return true;
+}
+
 void URuntimeArchiverBase::ExtractEntriesToStorage(const FRuntimeArchiverAsyncOperationResult& OnResult, const FRuntimeArchiverAsyncOperationProgress& OnProgress, TArray<FRuntimeArchiveEntry> EntryInfo, FString DirectoryPath, bool bForceOverwrite)
 {
 	if (!IsInitialized())
@@ -0,0 +1,218 @@
+﻿// Georgy Treshchev 2024.
+
+#include "Streams/RuntimeArchiverAsyncFileStream.h"
+
+#include "RuntimeArchiverDefines.h"
+#include "Async/AsyncFileHandle.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+
+FRuntimeArchiverAsyncFileStream::FRuntimeArchiverAsyncFileStream(const FString& ArchivePath, int32 NumOfRequests, int64 RequestSize)
+	: FRuntimeArchiverBaseStream(false)
+  , FileHandle{nullptr}
+  , FirstSlotIndex{0}
+  , NumOfUsedSlots{0}
+  , RequestSize{FMath::Max<int64>(RequestSize, 1)}
+  , NextRequestOffset{0}
+  , FileSize{0}
+{
+	IPlatformFile& PlatformFile{FPlatformFileManager::Get().GetPlatformFile()};
+
+	// Async handles may be created for the files that do not exist, so the file is checked separately
+	FileSize = PlatformFile.FileSize(*ArchivePath);
+	if (FileSize >= 0)
+	{
+		FileHandle = PlatformFile.OpenAsyncRead(*ArchivePath);
+	}
+
+	Slots.SetNum(FMath::Max<int32>(NumOfRequests, 1));
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("File opened at '%s' for async reading with %d requests of %lld bytes. Validity: %s"),
+	       *ArchivePath, Slots.Num(), this->RequestSize, FRuntimeArchiverAsyncFileStream::IsValid() ? TEXT("true") : TEXT("false"));
+}
+
+FRuntimeArchiverAsyncFileStream::~FRuntimeArchiverAsyncFileStream()
+{
+	// All requests must be completed before the handle is deleted
+	for (FReadSlot& Slot : Slots)
+	{
+		ReleaseRequest(Slot, true);
+	}
+
+	delete FileHandle;
+	FileHandle = nullptr;
+}
+
+bool FRuntimeArchiverAsyncFileStream::IsValid() const
+{
+	return FileHandle != nullptr;
+}
+
+bool FRuntimeArchiverAsyncFileStream::Read(void* Data, int64 Size)
+{
+	if (!IsValid() || Size < 0 || Position + Size > FileSize)
+	{
+		return false;
+	}
+
+	uint8* DataPtr = static_cast<uint8*>(Data);
+
+	while (Size > 0)
+	{
+		if (NumOfUsedSlots == 0 || Position < Slots[FirstSlotIndex].Offset || Position >= NextRequestOffset)
+		{
+			RestartRequests(Position);
+		}
+
+		FReadSlot& Slot = Slots[FirstSlotIndex];
+
+		// The position may have been moved forward past the data of the slot, which is then no longer needed
+		if (Position >= Slot.Offset + Slot.Size)
+		{
+			ReleaseRequest(Slot, true);
+			IssueRequest(Slot);
+			FirstSlotIndex = (FirstSlotIndex + 1) % Slots.Num();
+			continue;
+		}
+
+		if (!Slot.bCompleted)
+		{
+			Slot.Request->WaitCompletion();
+			Slot.bCompleted = true;
+
+			if (!Slot.Request->GetReadResults())
+			{
+				UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read %lld bytes at %lld from the file asynchronously"), Slot.Size, Slot.Offset);
+
+				// Dropping all requests, so that the next read requests the data again
+				RestartRequests(FileSize);
+				return false;
+			}
+		}
+
+		const int64 SlotPosition = Position - Slot.Offset;
+		const int64 CopySize = FMath::Min<int64>(Size, Slot.Size - SlotPosition);
+
+		FMemory::Memcpy(DataPtr, Slot.Buffer.GetData() + SlotPosition, CopySize);
+
+		DataPtr += CopySize;
+		Size -= CopySize;
+		Position += CopySize;
+
+		// The slot is reused for the next range once its data has been consumed
+		if (Position == Slot.Offset + Slot.Size)
+		{
+			ReleaseRequest(Slot, false);
+			IssueRequest(Slot);
+			FirstSlotIndex = (FirstSlotIndex + 1) % Slots.Num();
+		}
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverAsyncFileStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	if (!IsValid() || Offset < 0 || Size < 0 || Offset + Size > FileSize)
+	{
+		return false;
+	}
+
+	if (Size == 0)
+	{
+		return true;
+	}
+
+	IAsyncReadRequest* Request = FileHandle->ReadRequest(Offset, Size, AIOP_Normal, nullptr, static_cast<uint8*>(Data));
+
+	if (!Request)
+	{
+		return false;
+	}
+
+	Request->WaitCompletion();
+	const bool bSuccess = Request->GetReadResults() != nullptr;
+	delete Request;
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to read %lld bytes at %lld from the file asynchronously"), Size, Offset);
+	}
+
+	return bSuccess;
+}
+
+bool FRuntimeArchiverAsyncFileStream::Seek(int64 NewPosition)
+{
+	if (!IsValid() || NewPosition < 0 || NewPosition > FileSize)
+	{
+		return false;
+	}
+
+	// The requests are only restarted by the next read, if it is outside of the requested data
+	Position = NewPosition;
+
+	return true;
+}
+
+int64 FRuntimeArchiverAsyncFileStream::Size()
+{
+	if (!IsValid())
+	{
+		return -1;
+	}
+
+	return FileSize;
+}
+
+void FRuntimeArchiverAsyncFileStream::IssueRequest(FReadSlot& Slot)
+{
+	if (NextRequestOffset >= FileSize)
+	{
+		return;
+	}
+
+	Slot.Offset = NextRequestOffset;
+	Slot.Size = FMath::Min<int64>(RequestSize, FileSize - NextRequestOffset);
+	Slot.bCompleted = false;
+	Slot.Buffer.SetNumUninitialized(Slot.Size);
+	Slot.Request = FileHandle->ReadRequest(Slot.Offset, Slot.Size, AIOP_Normal, nullptr, Slot.Buffer.GetData());
+
+	NextRequestOffset += Slot.Size;
+	++NumOfUsedSlots;
+}
+
+void FRuntimeArchiverAsyncFileStream::ReleaseRequest(FReadSlot& Slot, bool bCancel)
+{
+	if (!Slot.Request)
+	{
+		return;
+	}
+
+	if (bCancel && !Slot.bCompleted)
+	{
+		Slot.Request->Cancel();
+	}
+
+	Slot.Request->WaitCompletion();
+	delete Slot.Request;
+	Slot.Request = nullptr;
+
+	--NumOfUsedSlots;
+}
+
+void FRuntimeArchiverAsyncFileStream::RestartRequests(int64 NewOffset)
+{
+	for (FReadSlot& Slot : Slots)
+	{
+		ReleaseRequest(Slot, true);
+	}
+
+	FirstSlotIndex = 0;
+	NextRequestOffset = NewOffset;
+
+	for (FReadSlot& Slot : Slots)
+	{
+		IssueRequest(Slot);
+	}
+}
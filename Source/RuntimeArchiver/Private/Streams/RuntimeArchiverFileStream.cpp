@@ -6,11 +6,23 @@
 #include "GenericPlatform/GenericPlatformFile.h"
 #include "HAL/PlatformFileManager.h"
 
-FRuntimeArchiverFileStream::FRuntimeArchiverFileStream(const FString& ArchivePath, bool bWrite)
+FRuntimeArchiverFileStream::FRuntimeArchiverFileStream(const FString& ArchivePath, bool bWrite, bool bAppend, int64 BufferSize)
 	: FRuntimeArchiverBaseStream(bWrite)
+  , ArchivePath{ArchivePath}
+  , BufferCapacity{FMath::Max<int64>(BufferSize, 0)}
+  , BufferOffset{0}
+  , DirtyStart{0}
+  , DirtyEnd{0}
+  , FileSize{0}
 {
 	IPlatformFile& PlatformFile{FPlatformFileManager::Get().GetPlatformFile()};
-	FileHandle = bWrite ? PlatformFile.OpenWrite(*ArchivePath, false, true) : PlatformFile.OpenRead(*ArchivePath, false);
+	FileHandle = bWrite ? PlatformFile.OpenWrite(*ArchivePath, bAppend, true) : PlatformFile.OpenRead(*ArchivePath, false);
+
+	if (FileHandle)
+	{
+		Position = FileHandle->Tell();
+		FileSize = FileHandle->Size();
+	}
 
 	UE_LOG(LogRuntimeArchiver, Log, TEXT("File opened at '%s', bWrite: %s. Validity: %s"),
 	       *ArchivePath, bWrite ? TEXT("true") : TEXT("false"), FRuntimeArchiverFileStream::IsValid() ? TEXT("true") : TEXT("false"));
@@ -20,6 +32,11 @@ FRuntimeArchiverFileStream::~FRuntimeArchiverFileStream()
 {
 	if (FRuntimeArchiverFileStream::IsValid())
 	{
+		if (!FlushBuffer())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write %lld buffered bytes to the file when closing it"), DirtyEnd - DirtyStart);
+		}
+
 		delete FileHandle;
 		FileHandle = nullptr;
 	}
@@ -32,13 +49,113 @@ bool FRuntimeArchiverFileStream::IsValid() const
 
 bool FRuntimeArchiverFileStream::Read(void* Data, int64 Size)
 {
-	if (!IsValid())
+	FScopeLock Lock(&FileLock);
+
+	if (!IsValid() || Size < 0 || Position + Size > FileSize)
+	{
+		return false;
+	}
+
+	uint8* DataPtr = static_cast<uint8*>(Data);
+
+	while (Size > 0)
+	{
+		const int64 BufferedSize = BufferOffset + Buffer.Num() - Position;
+
+		if (Position >= BufferOffset && BufferedSize > 0)
+		{
+			const int64 ChunkSize = FMath::Min<int64>(Size, BufferedSize);
+			FMemory::Memcpy(DataPtr, Buffer.GetData() + (Position - BufferOffset), ChunkSize);
+
+			DataPtr += ChunkSize;
+			Position += ChunkSize;
+			Size -= ChunkSize;
+			continue;
+		}
+
+		// The file must be up to date before reading it, since the buffer is about to be replaced
+		if (!FlushBuffer())
+		{
+			return false;
+		}
+
+		Buffer.Reset();
+
+		// Large reads go to the file directly, without an intermediate copy
+		if (Size >= BufferCapacity)
+		{
+			if (!FileHandle->Seek(Position) || !FileHandle->Read(DataPtr, Size))
+			{
+				return false;
+			}
+
+			Position += Size;
+			return true;
+		}
+
+		BufferOffset = Position;
+		Buffer.AddUninitialized(FMath::Min<int64>(BufferCapacity, FileSize - Position));
+
+		if (!FileHandle->Seek(BufferOffset) || !FileHandle->Read(Buffer.GetData(), Buffer.Num()))
+		{
+			Buffer.Reset();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverFileStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	if (!IsValid() || Offset < 0 || Size < 0)
+	{
+		return false;
+	}
+
+	if (bWrite)
+	{
+		FScopeLock Lock(&FileLock);
+
+		// The written data still in the buffer must reach the file before it is read through another handle
+		if (Offset + Size > FileSize || (IsRangeBuffered(Offset, Size) && !FlushBuffer()))
+		{
+			return false;
+		}
+	}
+	else if (Offset + Size > FileSize)
 	{
 		return false;
 	}
 
-	const bool bSuccess{FileHandle->Read(static_cast<uint8*>(Data), Size)};
-	Position = FileHandle->Tell();
+	TUniquePtr<IFileHandle> PositionalHandle;
+
+	{
+		FScopeLock Lock(&PositionalHandlesLock);
+
+		if (PositionalHandles.Num() > 0)
+		{
+			PositionalHandle = PositionalHandles.Pop();
+		}
+	}
+
+	if (!PositionalHandle.IsValid())
+	{
+		// The file opened for writing is only shared with the handles that allow it
+		PositionalHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*ArchivePath, bWrite));
+
+		if (!PositionalHandle.IsValid())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open file '%s' for positional reading"), *ArchivePath);
+			return false;
+		}
+	}
+
+	const bool bSuccess = PositionalHandle->Seek(Offset) && PositionalHandle->Read(static_cast<uint8*>(Data), Size);
+
+	FScopeLock Lock(&PositionalHandlesLock);
+	PositionalHandles.Add(MoveTemp(PositionalHandle));
+
 	return bSuccess;
 }
 
@@ -46,26 +163,147 @@ bool FRuntimeArchiverFileStream::Write(const void* Data, int64 Size)
 {
 	ensureMsgf(bWrite, TEXT("Cannot write data to the stream because it is in read-only mode"));
 
-	if (!IsValid())
+	FScopeLock Lock(&FileLock);
+
+	if (!IsValid() || Size < 0)
 	{
 		return false;
 	}
 
-	const bool bSuccess{FileHandle->Write(static_cast<const uint8*>(Data), Size)};
-	Position = FileHandle->Tell();
-	return bSuccess;
+	// Collecting the write in the buffer requires it to continue the buffered data without a gap and to fit into the buffer
+	const bool bFitsBuffer = Size < BufferCapacity && Position >= BufferOffset && Position <= BufferOffset + Buffer.Num() && Position + Size <= BufferOffset + BufferCapacity;
+
+	if (!bFitsBuffer)
+	{
+		if (!FlushBuffer())
+		{
+			return false;
+		}
+
+		Buffer.Reset();
+
+		// Large writes go to the file directly. The buffered data they might overlap has just been dropped
+		if (Size >= BufferCapacity)
+		{
+			if (!FileHandle->Seek(Position) || !FileHandle->Write(static_cast<const uint8*>(Data), Size))
+			{
+				return false;
+			}
+
+			Position += Size;
+			FileSize = FMath::Max<int64>(FileSize, Position);
+			return true;
+		}
+
+		BufferOffset = Position;
+	}
+
+	const int64 WriteStart = Position - BufferOffset;
+	const int64 WriteEnd = WriteStart + Size;
+
+	// Only a single range of the buffer is kept unwritten, so a write apart from it flushes it first
+	if (DirtyStart != DirtyEnd && (WriteEnd < DirtyStart || WriteStart > DirtyEnd) && !FlushBuffer())
+	{
+		return false;
+	}
+
+	if (Buffer.Num() < WriteEnd)
+	{
+		Buffer.Reserve(BufferCapacity);
+		Buffer.AddUninitialized(WriteEnd - Buffer.Num());
+	}
+
+	FMemory::Memcpy(Buffer.GetData() + WriteStart, Data, Size);
+
+	if (DirtyStart == DirtyEnd)
+	{
+		DirtyStart = WriteStart;
+		DirtyEnd = WriteEnd;
+	}
+	else
+	{
+		DirtyStart = FMath::Min<int64>(DirtyStart, WriteStart);
+		DirtyEnd = FMath::Max<int64>(DirtyEnd, WriteEnd);
+	}
+
+	Position += Size;
+	FileSize = FMath::Max<int64>(FileSize, Position);
+
+	return true;
+}
+
+bool FRuntimeArchiverFileStream::WriteAt(int64 Offset, const void* Data, int64 Size)
+{
+	ensureMsgf(bWrite, TEXT("Cannot write data to the stream because it is in read-only mode"));
+
+	if (!IsValid() || Offset < 0 || Size < 0)
+	{
+		return false;
+	}
+
+	FScopeLock Lock(&FileLock);
+
+	// The buffered data of the range would otherwise be read instead of the written data or written over it later
+	if (IsRangeBuffered(Offset, Size))
+	{
+		if (!FlushBuffer())
+		{
+			return false;
+		}
+
+		Buffer.Reset();
+	}
+
+	// Every use of the file handle seeks it first, so only the handle is moved and the position is left as is
+	if (!FileHandle->Seek(Offset) || !FileHandle->Write(static_cast<const uint8*>(Data), Size))
+	{
+		return false;
+	}
+
+	FileSize = FMath::Max<int64>(FileSize, Offset + Size);
+
+	return true;
 }
 
 bool FRuntimeArchiverFileStream::Seek(int64 NewPosition)
 {
-	if (!IsValid())
+	if (!IsValid() || NewPosition < 0)
 	{
 		return false;
 	}
 
-	const bool bSuccess{FileHandle->Seek(NewPosition)};
-	Position = FileHandle->Tell();
-	return bSuccess;
+	// The file handle is only moved once the position leaves the buffered data
+	Position = NewPosition;
+	return true;
+}
+
+bool FRuntimeArchiverFileStream::Truncate(int64 NewSize)
+{
+	ensureMsgf(bWrite, TEXT("Cannot truncate the stream because it is in read-only mode"));
+
+	FScopeLock Lock(&FileLock);
+
+	if (!IsValid() || !FlushBuffer() || !FileHandle->Truncate(NewSize))
+	{
+		return false;
+	}
+
+	FileSize = NewSize;
+
+	// The buffered data past the new end no longer exists in the file
+	if (BufferOffset + Buffer.Num() > NewSize)
+	{
+		Buffer.SetNum(FMath::Max<int64>(NewSize - BufferOffset, 0));
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverFileStream::Flush()
+{
+	FScopeLock Lock(&FileLock);
+
+	return IsValid() && FlushBuffer() && (!bWrite || FileHandle->Flush());
 }
 
 int64 FRuntimeArchiverFileStream::Size()
@@ -75,5 +313,32 @@ int64 FRuntimeArchiverFileStream::Size()
 		return -1;
 	}
 
-	return FileHandle->Size();
+	FScopeLock Lock(&FileLock);
+
+	return FileSize;
+}
+
+bool FRuntimeArchiverFileStream::IsRangeBuffered(int64 Offset, int64 Size) const
+{
+	return Buffer.Num() > 0 && Offset < BufferOffset + Buffer.Num() && BufferOffset < Offset + Size;
+}
+
+bool FRuntimeArchiverFileStream::FlushBuffer()
+{
+	if (DirtyStart == DirtyEnd)
+	{
+		return true;
+	}
+
+	const bool bSuccess = FileHandle->Seek(BufferOffset + DirtyStart) && FileHandle->Write(Buffer.GetData() + DirtyStart, DirtyEnd - DirtyStart);
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write %lld buffered bytes to the file at offset %lld"), DirtyEnd - DirtyStart, BufferOffset + DirtyStart);
+	}
+
+	DirtyStart = 0;
+	DirtyEnd = 0;
+
+	return bSuccess;
 }
@@ -0,0 +1,197 @@
+﻿// Georgy Treshchev 2024.
+
+#include "Streams/RuntimeArchiverHashingStream.h"
+
+#include "Misc/Crc.h"
+
+FRuntimeArchiverHashingStream::FRuntimeArchiverHashingStream(TUniquePtr<FRuntimeArchiverBaseStream> InInnerStream)
+	: FRuntimeArchiverBaseStream(InInnerStream->IsWrite())
+  , InnerStream{MoveTemp(InInnerStream)}
+  , Checksum{0}
+  , HashedSize{0}
+  , bIsChecksumValid{true}
+{
+	Position = InnerStream->Tell();
+}
+
+bool FRuntimeArchiverHashingStream::IsValid() const
+{
+	return InnerStream->IsValid();
+}
+
+bool FRuntimeArchiverHashingStream::IsSeekable() const
+{
+	return InnerStream->IsSeekable();
+}
+
+bool FRuntimeArchiverHashingStream::Seek(int64 NewPosition)
+{
+	const bool bSuccess = InnerStream->Seek(NewPosition);
+	Position = InnerStream->Tell();
+
+	return bSuccess;
+}
+
+bool FRuntimeArchiverHashingStream::Read(void* Data, int64 Size)
+{
+	const int64 Offset = Position;
+	const bool bSuccess = InnerStream->Read(Data, Size);
+
+	Position = InnerStream->Tell();
+
+	if (bSuccess)
+	{
+		HashData(Offset, Data, Size, false);
+	}
+
+	return bSuccess;
+}
+
+bool FRuntimeArchiverHashingStream::Write(const void* Data, int64 Size)
+{
+	const int64 Offset = Position;
+	const bool bSuccess = InnerStream->Write(Data, Size);
+
+	Position = InnerStream->Tell();
+
+	if (bSuccess)
+	{
+		HashData(Offset, Data, Size, true);
+	}
+
+	return bSuccess;
+}
+
+bool FRuntimeArchiverHashingStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	if (!InnerStream->ReadAt(Offset, Data, Size))
+	{
+		return false;
+	}
+
+	HashData(Offset, Data, Size, false);
+
+	return true;
+}
+
+bool FRuntimeArchiverHashingStream::WriteAt(int64 Offset, const void* Data, int64 Size)
+{
+	if (!InnerStream->WriteAt(Offset, Data, Size))
+	{
+		return false;
+	}
+
+	HashData(Offset, Data, Size, true);
+
+	return true;
+}
+
+bool FRuntimeArchiverHashingStream::Truncate(int64 NewSize)
+{
+	if (!InnerStream->Truncate(NewSize))
+	{
+		return false;
+	}
+
+	Position = InnerStream->Tell();
+
+	FScopeLock Lock(&ChecksumLock);
+
+	if (NewSize < HashedSize)
+	{
+		bIsChecksumValid = false;
+	}
+
+	return true;
+}
+
+bool FRuntimeArchiverHashingStream::Flush()
+{
+	return InnerStream->Flush();
+}
+
+int64 FRuntimeArchiverHashingStream::Size()
+{
+	return InnerStream->Size();
+}
+
+bool FRuntimeArchiverHashingStream::GetChecksum(uint32& OutChecksum)
+{
+	FScopeLock Lock(&ChecksumLock);
+
+	// The hashed data was overwritten, e.g. by patching a header or moving the entries, so the whole stream is hashed again
+	if (!bIsChecksumValid)
+	{
+		Checksum = 0;
+		HashedSize = 0;
+		bIsChecksumValid = true;
+	}
+
+	// Data that has not passed through the stream yet (e.g. skipped entries or the end-of-archive blocks) is read to complete the checksum
+	const int64 StreamSize = InnerStream->Size();
+	if (HashedSize < StreamSize)
+	{
+		TArray64<uint8> Buffer;
+		Buffer.SetNumUninitialized(FMath::Min<int64>(StreamSize - HashedSize, 1024 * 1024));
+
+		while (HashedSize < StreamSize)
+		{
+			const int64 ChunkSize = FMath::Min<int64>(StreamSize - HashedSize, Buffer.Num());
+			if (!InnerStream->ReadAt(HashedSize, Buffer.GetData(), ChunkSize))
+			{
+				return false;
+			}
+
+			Checksum = UpdateChecksum(Checksum, Buffer.GetData(), ChunkSize);
+			HashedSize += ChunkSize;
+		}
+	}
+	else if (HashedSize != StreamSize)
+	{
+		return false;
+	}
+
+	OutChecksum = Checksum;
+
+	return true;
+}
+
+uint32 FRuntimeArchiverHashingStream::UpdateChecksum(uint32 InChecksum, const void* Data, int64 Size)
+{
+	const uint8* DataPtr = static_cast<const uint8*>(Data);
+
+	while (Size > 0)
+	{
+		const int32 ChunkSize = static_cast<int32>(FMath::Min<int64>(Size, MAX_int32));
+
+		InChecksum = FCrc::MemCrc32(DataPtr, ChunkSize, InChecksum);
+
+		DataPtr += ChunkSize;
+		Size -= ChunkSize;
+	}
+
+	return InChecksum;
+}
+
+void FRuntimeArchiverHashingStream::HashData(int64 Offset, const void* Data, int64 Size, bool bIsWritten)
+{
+	FScopeLock Lock(&ChecksumLock);
+
+	if (!bIsChecksumValid)
+	{
+		return;
+	}
+
+	if (bIsWritten && Size > 0 && Offset < HashedSize)
+	{
+		bIsChecksumValid = false;
+		return;
+	}
+
+	// Only the part extending the hashed data is hashed. Data read again before it is already covered, and data after a gap cannot be hashed in order
+	if (Offset <= HashedSize && Offset + Size > HashedSize)
+	{
+		Checksum = UpdateChecksum(Checksum, static_cast<const uint8*>(Data) + (HashedSize - Offset), Offset + Size - HashedSize);
+		HashedSize = Offset + Size;
+	}
+}
@@ -0,0 +1,146 @@
+﻿// Georgy Treshchev 2024.
+
+#include "Streams/RuntimeArchiverMappedFileStream.h"
+
+#include "RuntimeArchiverDefines.h"
+#include "Streams/RuntimeArchiverFileStream.h"
+#include "Async/MappedFileHandle.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/EngineVersionComparison.h"
+
+FRuntimeArchiverMappedFileStream::FRuntimeArchiverMappedFileStream(const FString& ArchivePath, int64 FallbackBufferSize)
+	: FRuntimeArchiverBaseStream(false)
+{
+	IPlatformFile& PlatformFile{FPlatformFileManager::Get().GetPlatformFile()};
+
+#if UE_VERSION_OLDER_THAN(5, 3, 0)
+	MappedHandle.Reset(PlatformFile.OpenMapped(*ArchivePath));
+#else
+	FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*ArchivePath);
+	if (OpenResult.HasValue())
+	{
+		MappedHandle = OpenResult.StealValue();
+	}
+#endif
+
+	// Empty files cannot be mapped on all platforms, and there is nothing to map anyway
+	if (MappedHandle.IsValid() && MappedHandle->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		MappedData = TArrayView64<const uint8>(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+	}
+	else
+	{
+		MappedHandle.Reset();
+		FallbackStream = MakeUnique<FRuntimeArchiverFileStream>(ArchivePath, false, false, FallbackBufferSize);
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("File opened at '%s', mapped: %s. Validity: %s"),
+	       *ArchivePath, MappedRegion.IsValid() ? TEXT("true") : TEXT("false"), FRuntimeArchiverMappedFileStream::IsValid() ? TEXT("true") : TEXT("false"));
+}
+
+FRuntimeArchiverMappedFileStream::~FRuntimeArchiverMappedFileStream()
+{
+	// The region must be released before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+bool FRuntimeArchiverMappedFileStream::IsValid() const
+{
+	return MappedRegion.IsValid() || (FallbackStream.IsValid() && FallbackStream->IsValid());
+}
+
+bool FRuntimeArchiverMappedFileStream::Read(void* Data, int64 Size)
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	if (FallbackStream.IsValid())
+	{
+		if (!FallbackStream->Read(Data, Size))
+		{
+			return false;
+		}
+
+		Position = FallbackStream->Tell();
+		return true;
+	}
+
+	if (Size < 0 || Position + Size > MappedData.Num())
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(Data, MappedData.GetData() + Position, Size);
+	Position += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverMappedFileStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	if (FallbackStream.IsValid())
+	{
+		return FallbackStream->ReadAt(Offset, Data, Size);
+	}
+
+	if (Offset < 0 || Size < 0 || Offset + Size > MappedData.Num())
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(Data, MappedData.GetData() + Offset, Size);
+
+	return true;
+}
+
+bool FRuntimeArchiverMappedFileStream::Seek(int64 NewPosition)
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	if (FallbackStream.IsValid())
+	{
+		if (!FallbackStream->Seek(NewPosition))
+		{
+			return false;
+		}
+
+		Position = NewPosition;
+		return true;
+	}
+
+	if (NewPosition < 0 || NewPosition > MappedData.Num())
+	{
+		return false;
+	}
+
+	Position = NewPosition;
+
+	return true;
+}
+
+int64 FRuntimeArchiverMappedFileStream::Size()
+{
+	if (!IsValid())
+	{
+		return -1;
+	}
+
+	return FallbackStream.IsValid() ? FallbackStream->Size() : MappedData.Num();
+}
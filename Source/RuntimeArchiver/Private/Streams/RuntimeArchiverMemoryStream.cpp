@@ -3,13 +3,34 @@
 FRuntimeArchiverMemoryStream::FRuntimeArchiverMemoryStream(const TArray64<uint8>& ArchiveData)
 	: FRuntimeArchiverBaseStream(false)
   , ArchiveData(ArchiveData)
+  , ArchiveView(this->ArchiveData)
+{
+}
+
+FRuntimeArchiverMemoryStream::FRuntimeArchiverMemoryStream(TArray64<uint8>&& ArchiveData)
+	: FRuntimeArchiverBaseStream(false)
+  , ArchiveData(MoveTemp(ArchiveData))
+  , ArchiveView(this->ArchiveData)
+{
+}
+
+FRuntimeArchiverMemoryStream::FRuntimeArchiverMemoryStream(TArrayView64<const uint8> ArchiveData)
+	: FRuntimeArchiverBaseStream(false)
+  , ArchiveView(ArchiveData)
+{
+}
+
+FRuntimeArchiverMemoryStream::FRuntimeArchiverMemoryStream(TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> ArchiveData)
+	: FRuntimeArchiverBaseStream(false)
+  , SharedArchiveData(ArchiveData)
+  , ArchiveView(*ArchiveData)
 {
 }
 
 FRuntimeArchiverMemoryStream::FRuntimeArchiverMemoryStream(int32 InitialAllocationSize)
 	: FRuntimeArchiverBaseStream(true)
 {
-	ArchiveData.SetNum(InitialAllocationSize);
+	ArchiveData.Reserve(InitialAllocationSize);
 }
 
 bool FRuntimeArchiverMemoryStream::IsValid() const
@@ -24,15 +45,47 @@ bool FRuntimeArchiverMemoryStream::Read(void* Data, int64 Size)
 		return false;
 	}
 
-	if (Position + Size > ArchiveData.Num())
+	FReadScopeLock Lock(DataLock);
+
+	const TArrayView64<const uint8> ReadData = GetArchiveData();
+
+	if (Size < 0 || Position + Size > ReadData.Num())
 	{
 		return false;
 	}
 
-	const bool bSuccess{FMemory::Memcpy(Data, ArchiveData.GetData() + Position, Size) != nullptr};
+	// Empty reads, e.g. of empty entries, may pass no buffer at all
+	FMemory::Memcpy(Data, ReadData.GetData() + Position, Size);
 	Position += Size;
 
-	return bSuccess;
+	return true;
+}
+
+bool FRuntimeArchiverMemoryStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	// Read-only data never changes, so only the written data is locked
+	if (bWrite)
+	{
+		FReadScopeLock Lock(DataLock);
+
+		if (Offset < 0 || Size < 0 || Offset + Size > ArchiveData.Num())
+		{
+			return false;
+		}
+
+		FMemory::Memcpy(Data, ArchiveData.GetData() + Offset, Size);
+
+		return true;
+	}
+
+	if (Offset < 0 || Size < 0 || Offset + Size > ArchiveView.Num())
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(Data, ArchiveView.GetData() + Offset, Size);
+
+	return true;
 }
 
 bool FRuntimeArchiverMemoryStream::Write(const void* Data, int64 Size)
@@ -44,17 +97,41 @@ bool FRuntimeArchiverMemoryStream::Write(const void* Data, int64 Size)
 		return false;
 	}
 
-	const int64 NewPosition = Position + Size;
+	if (!WriteAt(Position, Data, Size))
+	{
+		return false;
+	}
+
+	Position += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverMemoryStream::WriteAt(int64 Offset, const void* Data, int64 Size)
+{
+	ensureMsgf(bWrite, TEXT("Cannot write data to the stream because it is in read-only mode"));
 
-	if (NewPosition > ArchiveData.Num())
+	if (!IsValid() || Offset < 0 || Size < 0)
 	{
-		ArchiveData.SetNumUninitialized(NewPosition);
+		return false;
 	}
 
-	const bool bSuccess{FMemory::Memcpy(ArchiveData.GetData() + Position, Data, Size) != nullptr};
-	Position = NewPosition;
+	{
+		FReadScopeLock Lock(DataLock);
+
+		if (Offset + Size <= ArchiveData.Num())
+		{
+			FMemory::Memcpy(ArchiveData.GetData() + Offset, Data, Size);
+			return true;
+		}
+	}
+
+	FWriteScopeLock Lock(DataLock);
 
-	return bSuccess;
+	GrowData(Offset + Size);
+	FMemory::Memcpy(ArchiveData.GetData() + Offset, Data, Size);
+
+	return true;
 }
 
 bool FRuntimeArchiverMemoryStream::Seek(int64 NewPosition)
@@ -69,19 +146,53 @@ bool FRuntimeArchiverMemoryStream::Seek(int64 NewPosition)
 		return true;
 	}
 
-	if (NewPosition > ArchiveData.Num())
+	if (bWrite)
 	{
-		if (NewPosition != 0)
+		bool bIsPastEnd;
 		{
-			return false;
+			FReadScopeLock Lock(DataLock);
+			bIsPastEnd = NewPosition > ArchiveData.Num();
+		}
+
+		// Seeking past the end in write mode extends the data with zeros, as files do
+		if (bIsPastEnd)
+		{
+			FWriteScopeLock Lock(DataLock);
+			GrowData(NewPosition);
 		}
 	}
+	else if (NewPosition > ArchiveView.Num())
+	{
+		return false;
+	}
 
 	Position = NewPosition;
 
 	return true;
 }
 
+bool FRuntimeArchiverMemoryStream::Truncate(int64 NewSize)
+{
+	ensureMsgf(bWrite, TEXT("Cannot truncate the stream because it is in read-only mode"));
+
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	FWriteScopeLock Lock(DataLock);
+
+	if (NewSize < 0 || NewSize > ArchiveData.Num())
+	{
+		return false;
+	}
+
+	ArchiveData.SetNum(NewSize);
+	Position = FMath::Min<int64>(Position, NewSize);
+
+	return true;
+}
+
 int64 FRuntimeArchiverMemoryStream::Size()
 {
 	if (!IsValid())
@@ -89,5 +200,16 @@ int64 FRuntimeArchiverMemoryStream::Size()
 		return -1;
 	}
 
-	return ArchiveData.Num();
+	FReadScopeLock Lock(DataLock);
+
+	return GetArchiveData().Num();
+}
+
+void FRuntimeArchiverMemoryStream::GrowData(int64 NewSize)
+{
+	// The data may have grown while the lock was being taken
+	if (NewSize > ArchiveData.Num())
+	{
+		ArchiveData.AddZeroed(NewSize - ArchiveData.Num());
+	}
 }
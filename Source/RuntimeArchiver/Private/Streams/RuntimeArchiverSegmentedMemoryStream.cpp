@@ -0,0 +1,207 @@
+﻿// Georgy Treshchev 2024.
+
+#include "Streams/RuntimeArchiverSegmentedMemoryStream.h"
+
+FRuntimeArchiverSegmentedMemoryStream::FRuntimeArchiverSegmentedMemoryStream(int64 InitialAllocationSize, int64 SegmentSize)
+	: FRuntimeArchiverBaseStream(true)
+  , SegmentSize{FMath::Max<int64>(SegmentSize, 1)}
+  , DataSize{0}
+{
+	if (InitialAllocationSize > 0)
+	{
+		Segments.Reserve(static_cast<int32>(FMath::DivideAndRoundUp<int64>(InitialAllocationSize, this->SegmentSize)));
+		Segments.AddDefaulted_GetRef().Reserve(FMath::Min<int64>(InitialAllocationSize, this->SegmentSize));
+	}
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::IsValid() const
+{
+	return true;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::Read(void* Data, int64 Size)
+{
+	if (!ReadAt(Position, Data, Size))
+	{
+		return false;
+	}
+
+	Position += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	FReadScopeLock Lock(SegmentsLock);
+
+	if (Offset < 0 || Size < 0 || Offset + Size > DataSize)
+	{
+		return false;
+	}
+
+	CopyData(Offset, static_cast<uint8*>(Data), Size, false);
+
+	return true;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::Write(const void* Data, int64 Size)
+{
+	if (!WriteAt(Position, Data, Size))
+	{
+		return false;
+	}
+
+	Position += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::WriteAt(int64 Offset, const void* Data, int64 Size)
+{
+	if (Offset < 0 || Size < 0)
+	{
+		return false;
+	}
+
+	{
+		FReadScopeLock Lock(SegmentsLock);
+
+		if (Offset + Size <= DataSize)
+		{
+			CopyData(Offset, static_cast<uint8*>(const_cast<void*>(Data)), Size, true);
+			return true;
+		}
+	}
+
+	FWriteScopeLock Lock(SegmentsLock);
+
+	GrowData(Offset + Size);
+	CopyData(Offset, static_cast<uint8*>(const_cast<void*>(Data)), Size, true);
+
+	return true;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::Seek(int64 NewPosition)
+{
+	if (NewPosition < 0)
+	{
+		return false;
+	}
+
+	// Seeking past the end extends the data with zeros, as files do
+	if (NewPosition > Size())
+	{
+		FWriteScopeLock Lock(SegmentsLock);
+		GrowData(NewPosition);
+	}
+
+	Position = NewPosition;
+
+	return true;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::Truncate(int64 NewSize)
+{
+	FWriteScopeLock Lock(SegmentsLock);
+
+	if (NewSize < 0 || NewSize > DataSize)
+	{
+		return false;
+	}
+
+	const int32 NumOfSegments = static_cast<int32>(FMath::DivideAndRoundUp<int64>(NewSize, SegmentSize));
+	Segments.SetNum(NumOfSegments);
+
+	if (NumOfSegments > 0)
+	{
+		Segments.Last().SetNum(NewSize - static_cast<int64>(NumOfSegments - 1) * SegmentSize);
+	}
+
+	DataSize = NewSize;
+	Position = FMath::Min<int64>(Position, NewSize);
+
+	return true;
+}
+
+int64 FRuntimeArchiverSegmentedMemoryStream::Size()
+{
+	FReadScopeLock Lock(SegmentsLock);
+
+	return DataSize;
+}
+
+bool FRuntimeArchiverSegmentedMemoryStream::ForEachSegment(TFunctionRef<bool(TArrayView64<const uint8> Segment)> Operation) const
+{
+	for (const TArray64<uint8>& Segment : Segments)
+	{
+		if (Segment.Num() > 0 && !Operation(TArrayView64<const uint8>(Segment)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FRuntimeArchiverSegmentedMemoryStream::GetContiguousData(TArray64<uint8>& Data) const
+{
+	Data.Reset(DataSize);
+
+	ForEachSegment([&Data](TArrayView64<const uint8> Segment)
+	{
+		Data.Append(Segment.GetData(), Segment.Num());
+		return true;
+	});
+}
+
+TArray64<uint8>& FRuntimeArchiverSegmentedMemoryStream::GetOrAddSegment(int64 SegmentIndex)
+{
+	while (Segments.Num() <= SegmentIndex)
+	{
+		// Only the first segment grows gradually, so that small archives do not allocate a whole segment
+		TArray64<uint8>& Segment = Segments.AddDefaulted_GetRef();
+		if (Segments.Num() > 1)
+		{
+			Segment.Reserve(SegmentSize);
+		}
+	}
+
+	return Segments[SegmentIndex];
+}
+
+void FRuntimeArchiverSegmentedMemoryStream::GrowData(int64 NewSize)
+{
+	// The data may have grown while the lock was being taken
+	while (DataSize < NewSize)
+	{
+		TArray64<uint8>& Segment = GetOrAddSegment(DataSize / SegmentSize);
+		const int64 ChunkSize = FMath::Min<int64>(NewSize - DataSize, SegmentSize - Segment.Num());
+
+		Segment.AddZeroed(ChunkSize);
+		DataSize += ChunkSize;
+	}
+}
+
+void FRuntimeArchiverSegmentedMemoryStream::CopyData(int64 Offset, uint8* Data, int64 Size, bool bIsWrite)
+{
+	while (Size > 0)
+	{
+		TArray64<uint8>& Segment = Segments[Offset / SegmentSize];
+		const int64 SegmentOffset = Offset % SegmentSize;
+		const int64 ChunkSize = FMath::Min<int64>(Size, SegmentSize - SegmentOffset);
+
+		if (bIsWrite)
+		{
+			FMemory::Memcpy(Segment.GetData() + SegmentOffset, Data, ChunkSize);
+		}
+		else
+		{
+			FMemory::Memcpy(Data, Segment.GetData() + SegmentOffset, ChunkSize);
+		}
+
+		Data += ChunkSize;
+		Offset += ChunkSize;
+		Size -= ChunkSize;
+	}
+}
@@ -0,0 +1,304 @@
+﻿// Georgy Treshchev 2024.
+
+#include "Streams/RuntimeArchiverVolumeStream.h"
+
+#include "RuntimeArchiverDefines.h"
+#include "ArchiverTar/RuntimeArchiverTarHeader.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/ScopeLock.h"
+
+FRuntimeArchiverVolumeStream::FRuntimeArchiverVolumeStream(const TArray<FString>& VolumePaths)
+	: FRuntimeArchiverBaseStream(false)
+  , VolumeSize{0}
+  , TotalSize{0}
+{
+	IPlatformFile& PlatformFile{FPlatformFileManager::Get().GetPlatformFile()};
+
+	for (const FString& VolumePath : VolumePaths)
+	{
+		TUniquePtr<FVolumeFile> VolumeFile = MakeUnique<FVolumeFile>();
+		VolumeFile->FileHandle.Reset(PlatformFile.OpenRead(*VolumePath, false));
+
+		if (!VolumeFile->FileHandle.IsValid())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to open tar volume '%s'"), *VolumePath);
+			Volumes.Reset();
+			return;
+		}
+
+		const int64 FileSize = VolumeFile->FileHandle->Size();
+
+		// The volume and continuation headers only describe where the volume starts, the archive data continues right after them
+		int64 HeaderSize = 0;
+		FTarHeader Header;
+
+		while (HeaderSize + static_cast<int64>(sizeof(Header)) <= FileSize && VolumeFile->FileHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header)) && Header.IsVolumeBoundary())
+		{
+			HeaderSize += sizeof(Header);
+		}
+
+		VolumeFile->Volume = FRuntimeArchiverVolume{VolumePath, TotalSize, FileSize - HeaderSize, HeaderSize};
+		TotalSize += VolumeFile->Volume.Size;
+
+		Volumes.Add(MoveTemp(VolumeFile));
+	}
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Opened %d tar volumes with %lld bytes of data. Validity: %s"), Volumes.Num(), TotalSize, FRuntimeArchiverVolumeStream::IsValid() ? TEXT("true") : TEXT("false"));
+}
+
+FRuntimeArchiverVolumeStream::FRuntimeArchiverVolumeStream(const FString& InArchivePath, int64 MaxVolumeSize)
+	: FRuntimeArchiverBaseStream(true)
+  , ArchivePath{InArchivePath}
+  , VolumeSize{MaxVolumeSize - MaxVolumeSize % 512}
+  , TotalSize{0}
+{
+	// The volumes after the first one hold the header and at least one block of data
+	if (VolumeSize < 512 * 2)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to create tar volumes of %lld bytes. Volumes must be at least 1024 bytes"), MaxVolumeSize);
+		return;
+	}
+
+	IPlatformFile& PlatformFile{FPlatformFileManager::Get().GetPlatformFile()};
+
+	// Volumes left over from an earlier archive with the same path would be taken for the continuation of this one
+	for (int32 VolumeIndex = 1; PlatformFile.FileExists(*GetVolumePath(ArchivePath, VolumeIndex)); ++VolumeIndex)
+	{
+		PlatformFile.DeleteFile(*GetVolumePath(ArchivePath, VolumeIndex));
+	}
+
+	// The first volume is created right away, so that an invalid path is reported upfront
+	FindVolume(0);
+
+	UE_LOG(LogRuntimeArchiver, Log, TEXT("Created tar volumes at '%s' with volume size %lld. Validity: %s"), *ArchivePath, VolumeSize, FRuntimeArchiverVolumeStream::IsValid() ? TEXT("true") : TEXT("false"));
+}
+
+FRuntimeArchiverVolumeStream::~FRuntimeArchiverVolumeStream()
+{
+	Volumes.Reset();
+}
+
+FString FRuntimeArchiverVolumeStream::GetVolumePath(const FString& ArchivePath, int32 VolumeIndex)
+{
+	return VolumeIndex == 0 ? ArchivePath : FString::Printf(TEXT("%s.%03d"), *ArchivePath, VolumeIndex);
+}
+
+bool FRuntimeArchiverVolumeStream::IsValid() const
+{
+	FScopeLock Lock(&VolumesLock);
+	return Volumes.Num() > 0;
+}
+
+bool FRuntimeArchiverVolumeStream::Read(void* Data, int64 Size)
+{
+	if (!ReadAt(Position, Data, Size))
+	{
+		return false;
+	}
+
+	Position += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverVolumeStream::Write(const void* Data, int64 Size)
+{
+	if (!WriteAt(Position, Data, Size))
+	{
+		return false;
+	}
+
+	Position += Size;
+
+	return true;
+}
+
+bool FRuntimeArchiverVolumeStream::Seek(int64 NewPosition)
+{
+	if (!IsValid() || NewPosition < 0)
+	{
+		return false;
+	}
+
+	// The volumes are created once the data reaches them, so any position can be reserved in write mode
+	if (!bWrite && NewPosition > Size())
+	{
+		return false;
+	}
+
+	Position = NewPosition;
+
+	return true;
+}
+
+int64 FRuntimeArchiverVolumeStream::Size()
+{
+	FScopeLock Lock(&VolumesLock);
+	return TotalSize;
+}
+
+bool FRuntimeArchiverVolumeStream::ReadAt(int64 Offset, void* Data, int64 Size)
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	uint8* DataPtr = static_cast<uint8*>(Data);
+
+	return ForEachVolumePart(Offset, Size, [DataPtr](IFileHandle& FileHandle, int64 FileOffset, int64 PartOffset, int64 PartSize)
+	{
+		return FileHandle.Seek(FileOffset) && FileHandle.Read(DataPtr + PartOffset, PartSize);
+	});
+}
+
+bool FRuntimeArchiverVolumeStream::WriteAt(int64 Offset, const void* Data, int64 Size)
+{
+	ensureMsgf(bWrite, TEXT("Cannot write data to the stream because it is in read-only mode"));
+
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	const uint8* DataPtr = static_cast<const uint8*>(Data);
+
+	const bool bSuccess = ForEachVolumePart(Offset, Size, [DataPtr](IFileHandle& FileHandle, int64 FileOffset, int64 PartOffset, int64 PartSize)
+	{
+		return FileHandle.Seek(FileOffset) && FileHandle.Write(DataPtr + PartOffset, PartSize);
+	});
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write %lld bytes to tar volumes at offset %lld"), Size, Offset);
+		return false;
+	}
+
+	FScopeLock Lock(&VolumesLock);
+	TotalSize = FMath::Max<int64>(TotalSize, Offset + Size);
+
+	return true;
+}
+
+bool FRuntimeArchiverVolumeStream::WriteVolumeHeader(int32 VolumeIndex, const void* Header)
+{
+	ensureMsgf(bWrite, TEXT("Cannot write data to the stream because it is in read-only mode"));
+
+	FVolumeFile* VolumeFile;
+
+	{
+		FScopeLock Lock(&VolumesLock);
+
+		if (VolumeIndex <= 0 || VolumeIndex >= Volumes.Num())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to write the header of tar volume %d because it has no reserved header"), VolumeIndex);
+			return false;
+		}
+
+		VolumeFile = Volumes[VolumeIndex].Get();
+	}
+
+	FScopeLock Lock(&VolumeFile->Lock);
+
+	return VolumeFile->FileHandle->Seek(0) && VolumeFile->FileHandle->Write(static_cast<const uint8*>(Header), VolumeFile->Volume.HeaderSize);
+}
+
+int32 FRuntimeArchiverVolumeStream::GetNumOfVolumes() const
+{
+	FScopeLock Lock(&VolumesLock);
+	return Volumes.Num();
+}
+
+TArray<FRuntimeArchiverVolume> FRuntimeArchiverVolumeStream::GetVolumes() const
+{
+	FScopeLock Lock(&VolumesLock);
+
+	TArray<FRuntimeArchiverVolume> Result;
+	Result.Reserve(Volumes.Num());
+
+	for (const TUniquePtr<FVolumeFile>& VolumeFile : Volumes)
+	{
+		Result.Add(VolumeFile->Volume);
+	}
+
+	return Result;
+}
+
+FRuntimeArchiverVolumeStream::FVolumeFile* FRuntimeArchiverVolumeStream::FindVolume(int64 Offset)
+{
+	FScopeLock Lock(&VolumesLock);
+
+	if (!bWrite)
+	{
+		// Searching from the end skips the empty volumes that start at the same position as the next one
+		for (int32 VolumeIndex = Volumes.Num() - 1; VolumeIndex >= 0; --VolumeIndex)
+		{
+			const FRuntimeArchiverVolume& Volume = Volumes[VolumeIndex]->Volume;
+
+			if (Offset >= Volume.Start)
+			{
+				return Offset < Volume.Start + Volume.Size ? Volumes[VolumeIndex].Get() : nullptr;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// All volumes but the first one hold one block of data less, since they start with their header
+	const int64 HeaderSize = 512;
+	const int32 VolumeIndex = Offset < VolumeSize ? 0 : 1 + static_cast<int32>((Offset - VolumeSize) / (VolumeSize - HeaderSize));
+
+	while (Volumes.Num() <= VolumeIndex)
+	{
+		const int32 NewVolumeIndex = Volumes.Num();
+		const FString VolumePath = GetVolumePath(ArchivePath, NewVolumeIndex);
+
+		TUniquePtr<FVolumeFile> VolumeFile = MakeUnique<FVolumeFile>();
+		VolumeFile->FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*VolumePath, false, true));
+
+		if (!VolumeFile->FileHandle.IsValid())
+		{
+			UE_LOG(LogRuntimeArchiver, Error, TEXT("Unable to create tar volume '%s'"), *VolumePath);
+			return nullptr;
+		}
+
+		VolumeFile->Volume = NewVolumeIndex == 0
+			                     ? FRuntimeArchiverVolume{VolumePath, 0, VolumeSize, 0}
+			                     : FRuntimeArchiverVolume{VolumePath, VolumeSize + (NewVolumeIndex - 1) * (VolumeSize - HeaderSize), VolumeSize - HeaderSize, HeaderSize};
+
+		Volumes.Add(MoveTemp(VolumeFile));
+	}
+
+	return Volumes[VolumeIndex].Get();
+}
+
+bool FRuntimeArchiverVolumeStream::ForEachVolumePart(int64 Offset, int64 Size, TFunctionRef<bool(IFileHandle& FileHandle, int64 FileOffset, int64 PartOffset, int64 PartSize)> Operation)
+{
+	for (int64 PartOffset = 0; PartOffset < Size;)
+	{
+		FVolumeFile* VolumeFile = FindVolume(Offset + PartOffset);
+
+		if (!VolumeFile)
+		{
+			return false;
+		}
+
+		// The location of a volume does not change once it is opened or created
+		const FRuntimeArchiverVolume& Volume = VolumeFile->Volume;
+		const int64 PartSize = FMath::Min<int64>(Size - PartOffset, Volume.Start + Volume.Size - (Offset + PartOffset));
+
+		{
+			FScopeLock Lock(&VolumeFile->Lock);
+
+			if (!Operation(*VolumeFile->FileHandle, Volume.HeaderSize + Offset + PartOffset - Volume.Start, PartOffset, PartSize))
+			{
+				return false;
+			}
+		}
+
+		PartOffset += PartSize;
+	}
+
+	return true;
+}
@@ -0,0 +1,287 @@
+﻿// Georgy Treshchev 2024.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RuntimeArchiverTypes.h"
+#include "ArchiverTar/RuntimeArchiverTar.h"
+#include "ArchiverTar/RuntimeArchiverTarHeader.h"
+#include "Streams/RuntimeArchiverMemoryStream.h"
+#include "HAL/PlatformTime.h"
+
+namespace RuntimeArchiverTarBenchmarks
+{
+	/** Number of distinct headers encoded and decoded in each pass */
+	constexpr int32 NumOfHeaders = 4096;
+
+	/** Number of passes over the headers */
+	constexpr int32 NumOfPasses = 200;
+
+	/**
+	 * Generate the entries of which the benchmarked headers are made. Names, sizes and times vary the way they do in real archives
+	 */
+	TArray<FRuntimeArchiveEntry> GenerateEntries()
+	{
+		TArray<FRuntimeArchiveEntry> Entries;
+		Entries.Reserve(NumOfHeaders);
+
+		for (int32 Index = 0; Index < NumOfHeaders; ++Index)
+		{
+			FRuntimeArchiveEntry Entry;
+			Entry.Name = FString::Printf(TEXT("Content/Folder%d/Subfolder%d/Asset_%d.uasset"), Index % 37, Index % 11, Index);
+			Entry.UncompressedSize = (static_cast<int64>(Index) * 2654435761LL) % (64LL * 1024 * 1024);
+			Entry.CreationTime = FDateTime::FromUnixTimestamp(1700000000LL + Index * 97LL);
+			Entry.bIsDirectory = Index % 16 == 0;
+			Entries.Add(MoveTemp(Entry));
+		}
+
+		return Entries;
+	}
+
+	/** Number of entries in the archive read from memory */
+	constexpr int32 NumOfArchivedEntries = 20000;
+
+	/** Number of passes over the archive read from memory */
+	constexpr int32 NumOfReadPasses = 5;
+
+	/**
+	 * Generate the content of the entries archived in memory. Sizes vary up to a few kilobytes, and the content has no zero runs, so that all entries are stored as regular ones
+	 */
+	TArray<TArray64<uint8>> GenerateContents()
+	{
+		TArray<TArray64<uint8>> Contents;
+		Contents.SetNum(NumOfArchivedEntries);
+
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			TArray64<uint8>& Content = Contents[Index];
+			Content.SetNumUninitialized((static_cast<int64>(Index) * 2654435761LL) % 4096);
+
+			for (int64 ByteIndex = 0; ByteIndex < Content.Num(); ++ByteIndex)
+			{
+				Content[ByteIndex] = static_cast<uint8>((Index * 31 + ByteIndex) | 1);
+			}
+		}
+
+		return Contents;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRuntimeArchiverTarHeaderCodecBenchmark, "RuntimeArchiver.Tar.Benchmarks.HeaderCodec", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FRuntimeArchiverTarHeaderCodecBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace RuntimeArchiverTarBenchmarks;
+
+	const TArray<FRuntimeArchiveEntry> Entries = GenerateEntries();
+
+	TArray<FTarHeader> Headers;
+	Headers.SetNum(NumOfHeaders);
+
+	// Encoding fills the numeric fields and builds the header checksum
+	const double EncodeStartTime = FPlatformTime::Seconds();
+	for (int32 Pass = 0; Pass < NumOfPasses; ++Pass)
+	{
+		for (int32 Index = 0; Index < NumOfHeaders; ++Index)
+		{
+			if (!FTarHeader::FromEntry(Entries[Index], Headers[Index]))
+			{
+				AddError(FString::Printf(TEXT("Unable to encode the header of '%s'"), *Entries[Index].Name));
+				return false;
+			}
+		}
+	}
+	const double EncodeTime = FPlatformTime::Seconds() - EncodeStartTime;
+
+	// Decoding verifies the header checksum and parses the numeric fields
+	FRuntimeArchiveEntry DecodedEntry;
+	const double DecodeStartTime = FPlatformTime::Seconds();
+	for (int32 Pass = 0; Pass < NumOfPasses; ++Pass)
+	{
+		for (int32 Index = 0; Index < NumOfHeaders; ++Index)
+		{
+			if (!FTarHeader::ToEntry(Headers[Index], Index, DecodedEntry))
+			{
+				AddError(FString::Printf(TEXT("Unable to decode the header of '%s'"), *Entries[Index].Name));
+				return false;
+			}
+		}
+	}
+	const double DecodeTime = FPlatformTime::Seconds() - DecodeStartTime;
+
+	for (int32 Index = 0; Index < NumOfHeaders; ++Index)
+	{
+		FTarHeader::ToEntry(Headers[Index], Index, DecodedEntry);
+		if (DecodedEntry.Name != Entries[Index].Name || DecodedEntry.UncompressedSize != Entries[Index].UncompressedSize || DecodedEntry.CreationTime != Entries[Index].CreationTime)
+		{
+			AddError(FString::Printf(TEXT("Header of '%s' does not round-trip"), *Entries[Index].Name));
+			return false;
+		}
+	}
+
+	const double NumOfProcessedHeaders = static_cast<double>(NumOfHeaders) * NumOfPasses;
+	AddInfo(FString::Printf(TEXT("Encode: %.2f M headers/s"), NumOfProcessedHeaders / EncodeTime / 1000000.0));
+	AddInfo(FString::Printf(TEXT("Decode: %.2f M headers/s"), NumOfProcessedHeaders / DecodeTime / 1000000.0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRuntimeArchiverTarInMemoryReadBenchmark, "RuntimeArchiver.Tar.Benchmarks.InMemoryRead", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FRuntimeArchiverTarInMemoryReadBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace RuntimeArchiverTarBenchmarks;
+
+	const TArray<TArray64<uint8>> Contents = GenerateContents();
+
+	TArray64<uint8> ArchiveData;
+	{
+		URuntimeArchiverTar* Writer = NewObject<URuntimeArchiverTar>();
+
+		if (!Writer->CreateArchiveInMemory())
+		{
+			AddError(TEXT("Unable to create the tar archive in memory"));
+			return false;
+		}
+
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			if (!Writer->AddEntryFromMemory(FString::Printf(TEXT("Asset_%d.uasset"), Index), Contents[Index], ERuntimeArchiverCompressionLevel::Compression0))
+			{
+				AddError(FString::Printf(TEXT("Unable to add entry %d to the tar archive"), Index));
+				return false;
+			}
+		}
+
+		if (!Writer->GetArchiveData(ArchiveData) || !Writer->CloseArchive())
+		{
+			AddError(TEXT("Unable to get the data of the tar archive"));
+			return false;
+		}
+	}
+
+	double OpenTime = 0;
+	double EnumerateTime = 0;
+	double ExtractTime = 0;
+	int64 NumOfExtractedBytes = 0;
+
+	for (int32 Pass = 0; Pass < NumOfReadPasses; ++Pass)
+	{
+		URuntimeArchiverTar* Reader = NewObject<URuntimeArchiverTar>();
+
+		// Opening builds the entry index by scanning the headers through the memory stream
+		const double OpenStartTime = FPlatformTime::Seconds();
+		if (!Reader->OpenArchiveFromMemory(TArrayView64<const uint8>(ArchiveData)))
+		{
+			AddError(TEXT("Unable to open the tar archive from memory"));
+			return false;
+		}
+		OpenTime += FPlatformTime::Seconds() - OpenStartTime;
+
+		TArray<FRuntimeArchiveEntry> Entries;
+		Entries.SetNum(NumOfArchivedEntries);
+
+		const double EnumerateStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			if (!Reader->GetArchiveEntryInfoByIndex(Index, Entries[Index]))
+			{
+				AddError(FString::Printf(TEXT("Unable to get the info of entry %d"), Index));
+				return false;
+			}
+		}
+		EnumerateTime += FPlatformTime::Seconds() - EnumerateStartTime;
+
+		TArray<TArray64<uint8>> ExtractedContents;
+		ExtractedContents.SetNum(NumOfArchivedEntries);
+
+		const double ExtractStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			if (!Reader->ExtractEntryToMemory(Entries[Index], ExtractedContents[Index]))
+			{
+				AddError(FString::Printf(TEXT("Unable to extract entry %d"), Index));
+				return false;
+			}
+		}
+		ExtractTime += FPlatformTime::Seconds() - ExtractStartTime;
+
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			if (ExtractedContents[Index] != Contents[Index])
+			{
+				AddError(FString::Printf(TEXT("Content of entry %d does not round-trip"), Index));
+				return false;
+			}
+
+			NumOfExtractedBytes += ExtractedContents[Index].Num();
+		}
+
+		Reader->CloseArchive();
+	}
+
+	// The entries were written one after another, each as a header followed by the padded content
+	TArray<int64> HeaderOffsets;
+	HeaderOffsets.SetNum(NumOfArchivedEntries);
+
+	int64 HeaderOffset = 0;
+	for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+	{
+		HeaderOffsets[Index] = HeaderOffset;
+		HeaderOffset += sizeof(FTarHeader) + (Contents[Index].Num() + 511) / 512 * 512;
+	}
+
+	// Reading the headers and the content of the entries through the memory stream is what extraction does, and copying the same ranges directly is what the in-memory fast path did instead
+	const TUniquePtr<FRuntimeArchiverBaseStream> Stream = MakeUnique<FRuntimeArchiverMemoryStream>(TArrayView64<const uint8>(ArchiveData));
+
+	FTarHeader Header;
+	TArray64<uint8> Content;
+	Content.SetNumUninitialized(4096);
+
+	// The offsets only match the archive layout if the content read from them is the archived one
+	for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+	{
+		if (!Stream->ReadAt(HeaderOffsets[Index] + sizeof(FTarHeader), Content.GetData(), Contents[Index].Num()) || FMemory::Memcmp(Content.GetData(), Contents[Index].GetData(), Contents[Index].Num()) != 0)
+		{
+			AddError(FString::Printf(TEXT("Content of entry %d read through the memory stream does not match the archived one"), Index));
+			return false;
+		}
+	}
+
+	double StreamReadTime = 0;
+	double DirectCopyTime = 0;
+
+	for (int32 Pass = 0; Pass < NumOfReadPasses; ++Pass)
+	{
+		const double StreamReadStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			if (!Stream->ReadAt(HeaderOffsets[Index], &Header, sizeof(FTarHeader)) || !Stream->ReadAt(HeaderOffsets[Index] + sizeof(FTarHeader), Content.GetData(), Contents[Index].Num()))
+			{
+				AddError(FString::Printf(TEXT("Unable to read entry %d through the memory stream"), Index));
+				return false;
+			}
+		}
+		StreamReadTime += FPlatformTime::Seconds() - StreamReadStartTime;
+
+		const double DirectCopyStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumOfArchivedEntries; ++Index)
+		{
+			FMemory::Memcpy(&Header, ArchiveData.GetData() + HeaderOffsets[Index], sizeof(FTarHeader));
+			FMemory::Memcpy(Content.GetData(), ArchiveData.GetData() + HeaderOffsets[Index] + sizeof(FTarHeader), Contents[Index].Num());
+		}
+		DirectCopyTime += FPlatformTime::Seconds() - DirectCopyStartTime;
+	}
+
+	const double NumOfProcessedEntries = static_cast<double>(NumOfArchivedEntries) * NumOfReadPasses;
+	AddInfo(FString::Printf(TEXT("Open: %.2f M entries/s"), NumOfProcessedEntries / OpenTime / 1000000.0));
+	AddInfo(FString::Printf(TEXT("Enumerate: %.2f M entries/s"), NumOfProcessedEntries / EnumerateTime / 1000000.0));
+	AddInfo(FString::Printf(TEXT("Extract: %.2f M entries/s, %.1f MB/s"), NumOfProcessedEntries / ExtractTime / 1000000.0, NumOfExtractedBytes / ExtractTime / (1024.0 * 1024.0)));
+	AddInfo(FString::Printf(TEXT("Stream reads: %.2f M entries/s, direct copies: %.2f M entries/s"), NumOfProcessedEntries / StreamReadTime / 1000000.0, NumOfProcessedEntries / DirectCopyTime / 1000000.0));
+	AddInfo(FString::Printf(TEXT("Reading through the stream instead of copying directly costs %.1f%% of the extraction time"), (StreamReadTime - DirectCopyTime) / ExtractTime * 100.0));
+
+	return true;
+}
+
+#endif
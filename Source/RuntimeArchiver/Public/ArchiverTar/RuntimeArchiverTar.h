@@ -5,11 +5,20 @@
 #include "CoreMinimal.h"
 #include "RuntimeArchiverBase.h"
 #include "Misc/EngineVersionComparison.h"
+#include "HAL/CriticalSection.h"
 #include "Streams/RuntimeArchiverBaseStream.h"
 #include "RuntimeArchiverTar.generated.h"
 
 struct FTarHeader;
+struct FTarSparseHeader;
+struct FRuntimeArchiverTarSparseRegion;
+struct FRuntimeArchiverVolume;
+class FRuntimeArchiverVolumeStream;
+class FRuntimeArchiverMemoryStream;
+class FRuntimeArchiverSegmentedMemoryStream;
+class FRuntimeArchiverHashingStream;
 class FRuntimeArchiverTarEncapsulator;
+class FRuntimeArchiverTarEntryReader;
 
 /**
  * Tar archiver class. Works with tar archives. Inspired by Microtar
@@ -20,6 +29,94 @@ class RUNTIMEARCHIVER_API URuntimeArchiverTar : public URuntimeArchiverBase
 	GENERATED_BODY()
 
 public:
+	/**
+	 * Default constructor
+	 */
+	URuntimeArchiverTar();
+
+	/**
+	 * Size of the buffer in which headers, data and padding are assembled into 512-byte blocks before being written to the stream, in bytes.
+	 * Rounded up to the tar block size. 0 disables buffering. Takes effect when the archive is created
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int32 WriteBufferSize;
+
+	/**
+	 * Size of the buffer through which the archive file is read ahead and written, in bytes. Seeks within the buffered data do not reach the file system
+	 * Reads and writes of at least this size bypass the buffer. 0 disables buffering. Takes effect when the archive is created or opened in storage
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int32 FileBufferSize;
+
+	/**
+	 * Whether to read the archive file through a memory mapping. Reads are served from the page cache without system calls, extraction writes the entries straight from the mapping
+	 * and GetEntryDataView is available. Falls back to the buffered file if the file cannot be mapped. Takes effect when the archive is opened in storage to read
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	bool bMemoryMapArchive;
+
+	/**
+	 * Number of asynchronous read requests kept in flight ahead of the read position, so that sequential reading of slow storage runs at the device bandwidth
+	 * 0 reads the archive file synchronously. Ignored if bMemoryMapArchive is set. Takes effect when the archive is opened in storage to read
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int32 NumOfAsyncReadRequests;
+
+	/**
+	 * Size of an asynchronous read request, in bytes. Used if NumOfAsyncReadRequests is not 0
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int32 AsyncReadRequestSize;
+
+	/**
+	 * Number of workers used by ExtractEntriesToStorage. Each worker reads its own entries at their offsets and writes them to storage concurrently with the others
+	 * 1 or less extracts the entries one at a time
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int32 NumOfExtractionWorkers;
+
+	/**
+	 * Size of the window in which ExtractEntriesToStorage reads the entry data ahead on another task while the data read before is written to storage, in bytes
+	 * Applies when the entries of an archive in storage are extracted one at a time, which are then read in archive order. 0 disables the prefetching
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int64 PrefetchWindowSize;
+
+	/**
+	 * Minimum size of a run of zeros, in bytes, to be stored as a hole of a GNU sparse entry instead of being written to the archive. Zeros are detected in whole 512-byte blocks
+	 * Holes are skipped by seeking when extracting to storage. 0 disables sparse entries, so that the archive stays readable by tools that do not support them. Not applied to archives split into volumes
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int32 SparseThreshold;
+
+	/**
+	 * Whether to store files whose content is identical to a file added earlier as hard links to that file instead of storing the content again
+	 * The content is matched by a 64-bit hash and confirmed by comparing the bytes. Only the files added since the archive was created or opened are considered
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	bool bDeduplicateEntries;
+
+	/**
+	 * Whether to save the entry index to a sidecar file ("<archive path>.idx") when an archive in storage is finalized, and to load it instead of reading all headers when the archive is opened
+	 * The index file is ignored if its fingerprint (archive size, modification time and hash of the archive head and tail) does not match the archive, and deleted once entries are removed, replaced or moved in place. Takes effect when the archive is created or opened
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	bool bUseIndexFile;
+
+	/**
+	 * Maximum size of each file of an archive created in storage, in bytes. Rounded down to the tar block size. Once a file is full, the archive continues in the next volume named by GetVolumePath,
+	 * and the entry that does not fit is continued there after a GNU continuation header, so that the volumes can be extracted with "tar -x -M". 0 creates a single file. Takes effect when the archive is created
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	int64 MaxVolumeSize;
+
+	/**
+	 * Whether to compute CRC32 checksums of the archive and of the entry data while the data is written or read, so that verifying them needs no extra pass over the archive
+	 * The entry checksums are reported in FRuntimeArchiveEntry::Checksum, the archive checksum by GetArchiveChecksum. Takes effect when the archive is created or opened
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Tar")
+	bool bComputeChecksums;
+
 	//~ Begin URuntimeArchiverBase Interface
 	virtual bool CreateArchiveInStorage(FString ArchivePath) override;
 	virtual bool CreateArchiveInMemory(int32 InitialAllocationSize = 0) override;
@@ -27,83 +124,708 @@ public:
 	virtual bool OpenArchiveFromStorage(FString ArchivePath) override;
 	virtual bool OpenArchiveFromMemory(const TArray64<uint8>& ArchiveData) override;
 
-	virtual bool CloseArchive() override;
+	virtual bool CloseArchive() override;
+
+	virtual bool GetArchiveData(TArray64<uint8>& ArchiveData) override;
+
+	virtual bool GetArchiveEntries(int32& NumOfArchiveEntries) override;
+
+	virtual bool GetArchiveEntryInfoByName(FString EntryName, FRuntimeArchiveEntry& EntryInfo) override;
+	virtual bool GetArchiveEntryInfoByIndex(int32 EntryIndex, FRuntimeArchiveEntry& EntryInfo) override;
+
+	virtual bool AddEntryFromMemory(FString EntryName, const TArray64<uint8>& DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel) override;
+
+	virtual void ExtractEntriesToStorage(const FRuntimeArchiverAsyncOperationResult& OnResult, const FRuntimeArchiverAsyncOperationProgress& OnProgress, TArray<FRuntimeArchiveEntry> EntryInfo, FString DirectoryPath, bool bForceOverwrite = true) override;
+
+	virtual bool ExtractEntryToMemory(const FRuntimeArchiveEntry& EntryInfo, TArray64<uint8>& UnarchivedData) override;
+
+	virtual bool Initialize() override;
+	virtual bool IsInitialized() const override;
+	virtual void Reset() override;
+
+	virtual void ReportError(ERuntimeArchiverErrorCode ErrorCode, const FString& ErrorString) const override;
+	//~ End URuntimeArchiverBase Interface
+
+	/**
+	 * Open an archive from storage to append. New entries are written in place of the end-of-archive marker, so the existing entries are not rewritten
+	 * Damaged archives are refused, since the new entries would overwrite whatever follows the last intact entry
+	 *
+	 * @param ArchivePath Path to open an archive
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Open")
+	bool OpenArchiveFromStorageToAppend(FString ArchivePath);
+
+	/**
+	 * Open an archive split into volumes from storage to read. The volumes are read as one archive with a single entry index, and may be located on different drives
+	 *
+	 * @param VolumePaths Paths to the volumes, in order
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Open")
+	bool OpenArchiveVolumesFromStorage(TArray<FString> VolumePaths);
+
+	/**
+	 * Open an archive from memory, taking ownership of the archive data instead of copying it
+	 *
+	 * @param ArchiveData Binary archive data
+	 * @return Whether the operation was successful or not
+	 */
+	bool OpenArchiveFromMemory(TArray64<uint8>&& ArchiveData);
+
+	/**
+	 * Open an archive from memory without copying the archive data. The data must outlive the opened archive and the extraction started on it
+	 *
+	 * @param ArchiveData Binary archive data
+	 * @return Whether the operation was successful or not
+	 */
+	bool OpenArchiveFromMemory(TArrayView64<const uint8> ArchiveData);
+
+	/**
+	 * Open an archive from memory, sharing ownership of the archive data instead of copying it. The data must not be modified while the archive is opened
+	 *
+	 * @param ArchiveData Binary archive data
+	 * @return Whether the operation was successful or not
+	 */
+	bool OpenArchiveFromMemory(TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> ArchiveData);
+
+	/**
+	 * Get the path of the volume of an archive created in storage with MaxVolumeSize. The first volume uses the archive path as is, the others append a three-digit volume number to it
+	 *
+	 * @param ArchivePath Path to the archive
+	 * @param VolumeIndex Volume index, starting from 0
+	 * @return Path of the volume
+	 */
+	UFUNCTION(BlueprintPure, Category = "Runtime Archiver|Tar")
+	static FString GetVolumePath(FString ArchivePath, int32 VolumeIndex);
+
+	/**
+	 * Remove the entry from the archive opened for writing. The entry is vacated in place, so that readers skip it, and the following entries are not moved
+	 * The vacated space is reclaimed by Compact, or by the next entries if the entry was the last one. Entries that hard links point to and entries of multi-volume archives cannot be removed
+	 *
+	 * @param EntryName Name of the entry to remove
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Remove")
+	bool RemoveEntry(FString EntryName);
+
+	/**
+	 * Replace the content of the entry in the archive opened for writing. The entry is rewritten in place if the new content fits into the space it occupies and is stored as a regular entry,
+	 * otherwise it is added again at the end of the archive, as a sparse entry or a hard link where applicable, and the old entry is removed once the new one is written. Entries that hard links point to and entries of multi-volume archives cannot be replaced
+	 *
+	 * @param EntryName Name of the entry to replace
+	 * @param DataToBeArchived New binary data of the entry
+	 * @param CompressionLevel Compression level. The higher the level, the more compression
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Add")
+	bool ReplaceEntry(FString EntryName, TArray<uint8> DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel = ERuntimeArchiverCompressionLevel::Compression6);
+
+	/**
+	 * Replace the content of the entry in the archive opened for writing. Prefer to use this function if possible
+	 *
+	 * @param EntryName Name of the entry to replace
+	 * @param DataToBeArchived New binary data of the entry
+	 * @param CompressionLevel Compression level. The higher the level, the more compression
+	 * @return Whether the operation was successful or not
+	 */
+	bool ReplaceEntry(FString EntryName, const TArray64<uint8>& DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel = ERuntimeArchiverCompressionLevel::Compression6);
+
+	/**
+	 * Add entry from memory. Unlike AddEntryFromMemory, it can be called from several threads at the same time: each call reserves the region of the entry
+	 * at the end of the archive and then writes the data at the reserved position, so that the producers only wait for each other while the region is reserved
+	 * If the data fails to be written, the reserved entry is vacated, or the archive is refused to be finalized for archives split into volumes
+	 * The entries are neither stored as sparse entries nor deduplicated. Other operations on the archive must not be performed until all the calls have returned
+	 *
+	 * @param EntryName Entry name
+	 * @param DataToBeArchived Binary data to be archived
+	 * @return Whether the operation was successful or not
+	 */
+	bool AddEntryFromMemoryConcurrently(FString EntryName, const TArray64<uint8>& DataToBeArchived);
+
+	/**
+	 * Begin adding an entry whose size is not known in advance. A placeholder header is written right away, the data is then appended with AppendEntryData
+	 * and the header is patched with the final size by EndEntry, so that the data does not have to be held in memory. No other entries can be added, removed or replaced until the entry is ended
+	 * The entries are neither stored as sparse entries nor deduplicated
+	 *
+	 * @param EntryName Entry name
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Add")
+	bool BeginEntry(FString EntryName);
+
+	/**
+	 * Append data to the entry begun with BeginEntry
+	 *
+	 * @param Data Binary data to append
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Add")
+	bool AppendEntryData(TArray<uint8> Data);
+
+	/**
+	 * Append data to the entry begun with BeginEntry. Prefer to use this function if possible
+	 *
+	 * @param Data Binary data to append
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool AppendEntryData(const void* Data, int64 Size);
+
+	/**
+	 * End the entry begun with BeginEntry, patching its header with the size of the appended data
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Add")
+	bool EndEntry();
+
+	/**
+	 * Reclaim the space vacated by removed or replaced entries by moving the entries that follow it towards the start of the archive. The entries before the first vacated region are not touched
+	 * The archive remains valid after each moved entry, so the compaction can be spread over several calls. The archive is shrunk once it is finalized. Multi-volume archives cannot be compacted
+	 *
+	 * @param MaxBytesToMove Number of bytes after which to stop moving entries. 0 or less moves all the entries that need it
+	 * @param bIsCompacted Whether no vacated space remains
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Remove")
+	bool Compact(int64 MaxBytesToMove, bool& bIsCompacted);
+
+	/**
+	 * Open a reader that returns the entry data in chunks of the caller's choosing instead of allocating the whole entry at once
+	 * Only one entry can be read at a time. Any other read operation on the archive invalidates the reader
+	 *
+	 * @param EntryInfo Information about the entry
+	 * @return Entry reader, or nullptr if the entry cannot be read
+	 */
+	TUniquePtr<FRuntimeArchiverTarEntryReader> OpenEntryReader(const FRuntimeArchiveEntry& EntryInfo);
+
+	/**
+	 * Get the entry data as a view into the archive, without copying it. Available for the archives opened in memory or memory-mapped from storage, and for non-sparse entries
+	 * The view remains valid until the archive is closed
+	 *
+	 * @param EntryInfo Archive entry to get the data of
+	 * @param EntryData Entry data view
+	 * @return Whether the operation was successful or not
+	 */
+	bool GetEntryDataView(const FRuntimeArchiveEntry& EntryInfo, TArrayView64<const uint8>& EntryData);
+
+	/**
+	 * Finalize the archive being written by writing the end-of-archive marker, so that its data is complete. No entries can be added afterwards
+	 * Closing the archive or getting its data finalizes it as well
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Tar")
+	bool FinalizeArchive();
+
+	/**
+	 * Get the CRC32 checksum of the whole archive, computed while the archive data was written or read. Requires bComputeChecksums
+	 * The parts of the archive that have not been written or read in order yet are read once to complete the checksum. Once entries were removed, replaced, compacted or their headers patched, the whole archive is read once instead
+	 * Not available for archives split into volumes. In write mode, the archive must be finalized with FinalizeArchive first
+	 *
+	 * @param Checksum CRC32 checksum of the archive
+	 * @return Whether the operation was successful or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Tar")
+	bool GetArchiveChecksum(int64& Checksum);
+
+protected:
+	//~ Begin URuntimeArchiverBase Interface
+	virtual bool AddFileEntryFromStorage(const FString& EntryName, const FString& FilePath, ERuntimeArchiverCompressionLevel CompressionLevel) override;
+	virtual bool ExtractFileEntryToStorage(const FRuntimeArchiveEntry& EntryInfo, const FString& FilePath) override;
+	//~ End URuntimeArchiverBase Interface
+
+private:
+	friend FRuntimeArchiverTarEntryReader;
+
+	/**
+	 * Open an archive from the memory stream to read
+	 *
+	 * @param MemoryStream Memory stream with the archive data
+	 * @return Whether the operation was successful or not
+	 */
+	bool OpenArchiveFromMemoryStream(TUniquePtr<FRuntimeArchiverMemoryStream> MemoryStream);
+
+	/**
+	 * Write the headers of all parent directories of the entry that have not been written yet, as required by the tar specification
+	 *
+	 * @param EntryName Entry name to parse the directories from
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteParentDirectoryEntries(const FString& EntryName);
+
+	/**
+	 * Write the header of a file entry, as a sparse entry if any holes are specified
+	 *
+	 * @param EntryName Entry name
+	 * @param Size Entry content size
+	 * @param SparseRegions Regions of the content that contain data. Empty if the entry is not sparse
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteFileHeader(const FString& EntryName, int64 Size, const TArray<FRuntimeArchiverTarSparseRegion>& SparseRegions);
+
+	/**
+	 * Find a file entry added earlier with the same content
+	 *
+	 * @param ContentHash Hash of the content
+	 * @param Size Content size
+	 * @param ReadContent Function that reads the specified range of the content, used to compare it byte by byte with the candidates
+	 * @param TargetName Name of the found entry
+	 * @return Whether the entry was found or not
+	 */
+	bool FindDuplicateEntry(uint64 ContentHash, int64 Size, TFunctionRef<bool(int64 Offset, uint8* Data, int64 ChunkSize)> ReadContent, FString& TargetName);
+
+	/**
+	 * Write a hard link entry that points to an earlier entry
+	 *
+	 * @param EntryName Entry name
+	 * @param TargetName Name of the entry to point to
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteHardLinkEntry(const FString& EntryName, const FString& TargetName);
+
+	/**
+	 * Find the entry to be removed or replaced, making sure the archive is opened for writing and no hard links point to the entry
+	 *
+	 * @param EntryName Entry name
+	 * @param OperationName Verb naming the operation, used in the error messages
+	 * @param EntryIndex Found entry index
+	 * @return Whether the entry can be modified or not
+	 */
+	bool FindModifiableEntry(const FString& EntryName, const TCHAR* OperationName, int32& EntryIndex);
+
+	/**
+	 * Check whether the new content of the entry can be written over its current content as a regular entry
+	 * Sparse content and content duplicating another entry are stored as a sparse entry or as a hard link instead, which are only written at the end of the archive
+	 *
+	 * @param EntryName Name of the entry to replace
+	 * @param Data New content of the entry
+	 * @param ContentHash Hash of the new content. Only computed if the entries are deduplicated
+	 * @return Whether the content can be written in place or not
+	 */
+	bool CanOverwriteEntry(const FString& EntryName, const TArray64<uint8>& Data, uint64& ContentHash);
+
+	/** Tar encapsulator. Shared with the asynchronous extraction, so that the archive data stays accessible until it finishes even if the archive is closed in the meantime */
+	TSharedPtr<FRuntimeArchiverTarEncapsulator, ESPMode::ThreadSafe> TarEncapsulator;
+};
+
+/**
+ * Region of a sparse entry that contains data. The content outside of the regions consists of zeros that are not stored in the archive
+ */
+struct FRuntimeArchiverTarSparseRegion
+{
+	/** Offset of the region in the entry content */
+	int64 Offset;
+
+	/** Region size */
+	int64 Size;
+};
+
+/**
+ * Location of a tar entry within the archive stream. Used to access entries without scanning the archive
+ */
+struct FRuntimeArchiverTarEntryRecord
+{
+	/** Entry name as stored in the header */
+	FString Name;
+
+	/** Position of the entry header */
+	int64 HeaderOffset;
+
+	/** Position of the entry data */
+	int64 DataOffset;
+
+	/** Entry data size as stored in the archive */
+	int64 Size;
+
+	/** Entry content size. Differs from Size only for sparse entries, where it also includes the holes */
+	int64 RealSize;
+
+	/** Regions of a sparse entry stored one after another in the entry data. Empty for regular entries */
+	TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+	/** Name of the entry a hard link points to. Empty for other entries */
+	FString LinkName;
+
+	/** CRC32 checksum of the entry data as stored in the archive, computed when the data was last written or read in full. -1 if it has not been computed */
+	int64 Checksum = -1;
+
+	/** Hash of the entry content. Only set for the entries written with deduplication enabled */
+	uint64 ContentHash = 0;
+
+	/** Whether ContentHash is set or not */
+	bool bHasContentHash = false;
+};
+
+/**
+ * Key functions of the maps keyed by entry name. Tar entry names are case-sensitive, unlike the default FString keys
+ */
+template <typename ValueType>
+struct TRuntimeArchiverTarEntryNameKeyFuncs : BaseKeyFuncs<TPair<FString, ValueType>, FString, false>
+{
+	static const FString& GetSetKey(const TPair<FString, ValueType>& Element)
+	{
+		return Element.Key;
+	}
+
+	static bool Matches(const FString& A, const FString& B)
+	{
+		return A.Equals(B, ESearchCase::CaseSensitive);
+	}
+
+	static uint32 GetKeyHash(const FString& Key)
+	{
+		return FCrc::StrCrc32(*Key);
+	}
+};
+
+/**
+ * Encapsulator between archiver and stream that implements intermediate operations
+ */
+class FRuntimeArchiverTarEncapsulator
+{
+public:
+	/**
+	 * @param InWriteBufferSize Size of the buffer used to assemble written records before flushing them to the stream. 0 disables buffering
+	 * @param InFileBufferSize Size of the buffer of the file stream, for archives in storage. 0 disables buffering
+	 * @param bInUseIndexFile Whether to save the entry index to a sidecar file on finalization and load it on open, for archives in storage
+	 * @param bInMemoryMapArchive Whether to read archives in storage through a memory mapping
+	 * @param InNumOfAsyncReadRequests Number of asynchronous read requests kept in flight when reading archives in storage. 0 reads them synchronously
+	 * @param InAsyncReadRequestSize Size of an asynchronous read request
+	 * @param bInComputeChecksums Whether to compute the checksums of the archive and of the entry data while the data is written or read
+	 */
+	FRuntimeArchiverTarEncapsulator(int64 InWriteBufferSize, int64 InFileBufferSize, bool bInUseIndexFile, bool bInMemoryMapArchive, int32 InNumOfAsyncReadRequests, int64 InAsyncReadRequestSize, bool bInComputeChecksums);
+	virtual ~FRuntimeArchiverTarEncapsulator();
+
+	/**
+	 * Check if the archive is successfully opened or not
+	 *
+	 * @return Whether the archive is successfully opened or not
+	 */
+	bool IsValid();
+
+	/**
+	 * Test if tar archive contains valid data or not. Only the first header is checked for performance
+	 * 
+	 * @return Whether the archive contains valid data or not
+	 */
+	bool TestArchive();
+
+	/**
+	 * Open a tar archive from a file as a stream for reading or writing
+	 *
+	 * @param ArchivePath Path to archive to open
+	 * @param bWrite Whether to open for writing or for reading
+	 * @return Whether the archive was successfully opened or not
+	 */
+	bool OpenFile(const FString& ArchivePath, bool bWrite);
+
+	/**
+	 * Open an existing tar archive from a file as a stream for appending entries. The entry index is built from the existing headers
+	 *
+	 * @param ArchivePath Path to archive to open
+	 * @return Whether the archive was successfully opened or not
+	 */
+	bool OpenFileToAppend(const FString& ArchivePath);
+
+	/**
+	 * Open a tar archive from memory as a stream for reading or writing
+	 *
+	 * @param ArchiveData Tar archive data. Must be empty if read-only mode is used
+	 * @param InitialAllocationSize Estimated archive size if known. Avoids unnecessary memory allocation. Must be empty if read-only mode is used
+	 * @param bWrite Whether to open for writing or for reading
+	 * @return Whether the archive was successfully opened or not
+	 */
+	bool OpenMemory(const TArray64<uint8>& ArchiveData, int32 InitialAllocationSize, bool bWrite);
+
+	/**
+	 * Open a tar archive from the memory stream. Allows reading the archive data without copying it
+	 *
+	 * @param MemoryStream Memory stream to open. The encapsulator takes ownership of it
+	 * @return Whether the archive was successfully opened or not
+	 */
+	bool OpenMemory(TUniquePtr<FRuntimeArchiverMemoryStream> MemoryStream);
+
+	/**
+	 * Open a tar archive split into volumes as a stream for reading
+	 *
+	 * @param VolumePaths Paths to the volumes, in order
+	 * @return Whether the archive was successfully opened or not
+	 */
+	bool OpenVolumes(const TArray<FString>& VolumePaths);
+
+	/**
+	 * Create a tar archive split into volumes as a stream for writing
+	 *
+	 * @param ArchivePath Path to the first volume
+	 * @param MaxVolumeSize Maximum size of each volume
+	 * @return Whether the archive was successfully created or not
+	 */
+	bool CreateVolumes(const FString& ArchivePath, int64 MaxVolumeSize);
+
+	/**
+	 * Whether the archive is split into volumes
+	 */
+	bool IsMultiVolume() const { return VolumeStream != nullptr; }
+
+	/**
+	 * Build the entry index by scanning all headers of the archive once
+	 *
+	 * @return Whether the index was successfully built or not
+	 */
+	bool BuildEntryIndex();
+
+	/**
+	 * Build the entry index by scanning all headers of the archive once
+	 *
+	 * @param EndOfEntriesOffset Position right after the last entry, where the end-of-archive marker starts
+	 * @param bIsDamaged Whether the headers end with damaged data instead of the end-of-archive marker, in which case only the preceding entries are indexed
+	 * @return Whether the index was successfully built or not
+	 */
+	bool BuildEntryIndex(int64& EndOfEntriesOffset, bool& bIsDamaged);
+
+	/**
+	 * Find the entry index by the entry name using the entry index
+	 *
+	 * @param EntryName Entry name to look for
+	 * @param Index Found entry index
+	 * @return Whether the entry was found or not
+	 */
+	bool FindEntryIndex(const FString& EntryName, int32& Index) const;
+
+	/**
+	 * Check whether an entry with the specified name has already been read or written. Used to avoid writing duplicate directory entries
+	 *
+	 * @param EntryName Entry name to look for
+	 * @return Whether the entry exists or not
+	 */
+	bool ContainsEntry(const FString& EntryName) const;
+
+	/**
+	 * Get the location of the entry with the specified index
+	 *
+	 * @param Index Entry index
+	 * @param Record Entry location
+	 * @return Whether the entry exists or not
+	 */
+	bool GetEntryRecord(int32 Index, FRuntimeArchiverTarEntryRecord& Record) const;
+
+	/**
+	 * Follow the hard links starting at the entry with the specified index to the entry that holds the data
+	 *
+	 * @param Index Entry index. Replaced with the index of the entry that holds the data
+	 * @return Whether the entry holding the data was found or not
+	 */
+	bool ResolveHardLink(int32& Index) const;
+
+	/**
+	 * Associate the content hash with the entry written last, so that entries with the same content can be found later
+	 *
+	 * @param ContentHash Hash of the entry content
+	 */
+	void AddContentHash(uint64 ContentHash);
+
+	/**
+	 * Associate the content hash with the entry with the specified index, replacing the hash it was associated with before
+	 *
+	 * @param Index Entry index
+	 * @param ContentHash Hash of the entry content
+	 */
+	void SetEntryContentHash(int32 Index, uint64 ContentHash);
+
+	/**
+	 * Dissociate the entry with the specified index from its content hash, so that no entry is deduplicated against it
+	 *
+	 * @param Index Entry index
+	 */
+	void ClearEntryContentHash(int32 Index);
+
+	/**
+	 * Find the entries with the specified content hash
+	 *
+	 * @param ContentHash Content hash to look for
+	 * @param Indices Indices of the entries, in the order they were associated with the hash
+	 */
+	void FindEntriesByContentHash(uint64 ContentHash, TArray<int32>& Indices) const;
+
+	/**
+	 * Read the specified range of the entry content, regardless of the current read/write position. The holes of sparse entries are read as zeros
+	 *
+	 * @param Index Entry index
+	 * @param ContentOffset Offset in the entry content
+	 * @param Data Buffer to read the content into
+	 * @param Size Number of bytes to read
+	 * @return Whether the operation was successful or not
+	 */
+	bool ReadEntryContent(int32 Index, int64 ContentOffset, uint8* Data, int64 Size);
+
+	/**
+	 * Check whether any hard link points to the entry with the specified index
+	 *
+	 * @param Index Entry index
+	 * @return Whether the entry is the target of a hard link or not
+	 */
+	bool IsHardLinkTarget(int32 Index) const;
+
+	/**
+	 * Get the number of bytes the entry with the specified index occupies in the archive, including its headers and padding
+	 *
+	 * @param Index Entry index
+	 * @return Occupied size, or 0 if the entry does not exist
+	 */
+	int64 GetEntrySpan(int32 Index) const;
+
+	/**
+	 * Remove the entry with the specified index. Its region, merged with the adjacent vacated regions, is vacated in place
+	 * If it was the last entry, the write position is moved back to its header instead
+	 *
+	 * @param Index Entry index
+	 * @return Whether the operation was successful or not
+	 */
+	bool RemoveEntry(int32 Index);
+
+	/**
+	 * Write all buffered data through to the archive, so that the entries written so far are actually stored in it
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool Flush();
+
+	/**
+	 * Rewrite the entry with the specified index in place with a regular entry. The space left over after the new entry is vacated
+	 *
+	 * @param Index Entry index
+	 * @param Header Header of the new entry
+	 * @param Data Data of the new entry
+	 * @param Size Data size. The new entry must not occupy more space than the old one
+	 * @return Whether the operation was successful or not
+	 */
+	bool OverwriteEntry(int32 Index, const FTarHeader& Header, const void* Data, int64 Size);
+
+	/**
+	 * Move the entries that follow the vacated regions towards the start of the archive, one at a time
+	 *
+	 * @param MaxBytesToMove Number of bytes after which to stop moving entries. 0 or less moves all the entries that need it
+	 * @param bIsCompacted Whether no vacated regions remain
+	 * @return Whether the operation was successful or not
+	 */
+	bool Compact(int64 MaxBytesToMove, bool& bIsCompacted);
+
+	/**
+	 * Write the header of a regular entry and reserve the region of its data right after it, moving the write position past the region
+	 * The data is then written at the reserved position with WriteReservedData, possibly from another thread
+	 *
+	 * @param Header Header of the entry
+	 * @param DataOffset Position of the reserved data region
+	 * @return Whether the operation was successful or not
+	 */
+	bool ReserveEntry(const FTarHeader& Header, int64& DataOffset);
 
-	virtual bool GetArchiveData(TArray64<uint8>& ArchiveData) override;
+	/**
+	 * Write the data of an entry, followed by its padding, into the region reserved by ReserveEntry. Keeps the current write position
+	 * The data is written without holding the write lock, so that the producers write their data at the same time
+	 * If it fails, the reserved entry is vacated, or the archive is marked as damaged and refused to be finalized if it cannot be
+	 *
+	 * @param DataOffset Position of the reserved data region
+	 * @param Data Data of the entry
+	 * @param Size Data size. Must match the size in the header of the entry
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteReservedData(int64 DataOffset, const void* Data, int64 Size);
 
-	virtual bool GetArchiveEntries(int32& NumOfArchiveEntries) override;
+	/**
+	 * Write the placeholder header of an entry whose size is not known yet. The data is then appended with AppendStreamedEntryData
+	 *
+	 * @param Header Header of the entry with zero size
+	 * @return Whether the operation was successful or not
+	 */
+	bool BeginStreamedEntry(const FTarHeader& Header);
 
-	virtual bool GetArchiveEntryInfoByName(FString EntryName, FRuntimeArchiveEntry& EntryInfo) override;
-	virtual bool GetArchiveEntryInfoByIndex(int32 EntryIndex, FRuntimeArchiveEntry& EntryInfo) override;
+	/**
+	 * Append data to the entry begun with BeginStreamedEntry
+	 *
+	 * @param Data Data to append
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool AppendStreamedEntryData(const void* Data, int64 Size);
 
-	virtual bool AddEntryFromMemory(FString EntryName, const TArray64<uint8>& DataToBeArchived, ERuntimeArchiverCompressionLevel CompressionLevel) override;
+	/**
+	 * Write the padding of the entry begun with BeginStreamedEntry and patch its header with the size of the appended data
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool EndStreamedEntry();
 
-	virtual bool ExtractEntryToMemory(const FRuntimeArchiveEntry& EntryInfo, TArray64<uint8>& UnarchivedData) override;
+	/**
+	 * Whether an entry begun with BeginStreamedEntry has not been ended yet
+	 */
+	bool IsStreamingEntry() const { return StreamedEntryHeader.IsValid(); }
 
-	virtual bool Initialize() override;
-	virtual bool IsInitialized() const override;
-	virtual void Reset() override;
+	/**
+	 * Get the lock that serializes the access to the stream and the entry index between concurrent writers
+	 */
+	FCriticalSection& GetWriteLock() { return WriteLock; }
 
-	virtual void ReportError(ERuntimeArchiverErrorCode ErrorCode, const FString& ErrorString) const override;
-	//~ End URuntimeArchiverBase Interface
+	/**
+	 * Check whether the end-of-archive marker has been written
+	 */
+	bool IsFinalized() const { return bIsFinalized; }
 
-private:
-	/** Tar encapsulator */
-	TUniquePtr<FRuntimeArchiverTarEncapsulator> TarEncapsulator;
-};
+	/**
+	 * Get the data of the archive opened in memory or memory-mapped for reading. Empty for other archives
+	 */
+	TArrayView64<const uint8> GetArchiveMemory() const { return ArchiveMemory; }
 
-/**
- * Encapsulator between archiver and stream that implements intermediate operations
- */
-class FRuntimeArchiverTarEncapsulator
-{
-public:
-	FRuntimeArchiverTarEncapsulator();
-	virtual ~FRuntimeArchiverTarEncapsulator();
+	/**
+	 * Get the stream the archive is read from or written to. Its positional reads can be used from several threads at the same time
+	 */
+	FRuntimeArchiverBaseStream* GetStream() const { return Stream.Get(); }
 
 	/**
-	 * Check if the archive is successfully opened or not
-	 *
-	 * @return Whether the archive is successfully opened or not
+	 * Get the files of the archive opened from storage. A single volume covering the whole file unless the archive is split into volumes, none for archives opened in memory
 	 */
-	bool IsValid();
+	TArray<FRuntimeArchiverVolume> GetArchiveVolumes() const;
 
 	/**
-	 * Test if tar archive contains valid data or not. Only the first header is checked for performance
-	 * 
-	 * @return Whether the archive contains valid data or not
+	 * Whether the checksums of the archive and of the entry data are computed
 	 */
-	bool TestArchive();
+	bool IsComputingChecksums() const { return bComputeChecksums; }
 
 	/**
-	 * Open a tar archive from a file as a stream for reading or writing
+	 * Get the checksum of the entry data
 	 *
-	 * @param ArchivePath Path to archive to open
-	 * @param bWrite Whether to open for writing or for reading
-	 * @return Whether the archive was successfully opened or not
+	 * @param Index Entry index
+	 * @return CRC32 checksum of the entry data, or -1 if it has not been computed
 	 */
-	bool OpenFile(const FString& ArchivePath, bool bWrite);
+	int64 GetEntryChecksum(int32 Index) const;
 
 	/**
-	 * Open a tar archive from memory as a stream for reading or writing
+	 * Record the checksum of the entry data once the data has been written or read in full. Can be called from several threads at the same time
 	 *
-	 * @param ArchiveData Tar archive data. Must be empty if read-only mode is used
-	 * @param InitialAllocationSize Estimated archive size if known. Avoids unnecessary memory allocation. Must be empty if read-only mode is used
-	 * @param bWrite Whether to open for writing or for reading
-	 * @return Whether the archive was successfully opened or not
+	 * @param Index Entry index
+	 * @param Checksum CRC32 checksum of the entry data
 	 */
-	bool OpenMemory(const TArray64<uint8>& ArchiveData, int32 InitialAllocationSize, bool bWrite);
+	void SetEntryChecksum(int32 Index, uint32 Checksum);
 
 	/**
-	 * Find header from the tar archive. Optionally updates the reading position of the found header. Works similar to the std::find_if algorithm
+	 * Get the checksum of the whole archive, computed while the archive data was written or read. In write mode, the archive must be finalized first
 	 *
-	 * @param ComparePredicate Compare predicate. Should return true when header is found, false otherwise. The first parameter is the header that can be the target, the second is its index in the archive
-	 * @param Header Found header
-	 * @param Index Found entry index
+	 * @param Checksum CRC32 checksum of the archive
+	 * @return Whether the operation was successful or not
+	 */
+	bool GetArchiveChecksum(uint32& Checksum);
+
+	/**
+	 * Read the header of the entry with the specified index. Optionally updates the reading position to the read header
+	 *
+	 * @param Index Entry index
+	 * @param Header Read header
 	 * @param bRemainPosition Whether to keep the previous read/write position, or update
-	 * @return Whether the header was found or not
+	 * @return Whether the header was read or not
 	 */
-	bool FindIf(TFunctionRef<bool(const FTarHeader&, int32)> ComparePredicate, FTarHeader& Header, int32& Index, bool bRemainPosition);
+	bool ReadHeaderByIndex(int32 Index, FTarHeader& Header, bool bRemainPosition);
 
 	/**
 	 * Get the number of tar archive entries
@@ -151,6 +873,15 @@ public:
 	 */
 	bool ReadData(TArray64<uint8>& UnarchivedData);
 
+	/**
+	 * Read the archived data from the current position. Can be called multiple times to read the entry data in chunks
+	 *
+	 * @param Data Buffer to read the data into
+	 * @param Size Number of bytes to read. Must not exceed the remaining entry data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool ReadData(void* Data, int64 Size);
+
 	/**
 	 * Write the header from the current position
 	 *
@@ -159,6 +890,16 @@ public:
 	 */
 	bool WriteHeader(const FTarHeader& Header);
 
+	/**
+	 * Write the sparse header followed by its extension headers from the current position
+	 *
+	 * @param Header Header to write
+	 * @param ExtensionHeaders Extension headers with the rest of the sparse map
+	 * @param SparseRegions Sparse regions described by the headers
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteHeader(const FTarHeader& Header, const TArray<FTarSparseHeader>& ExtensionHeaders, const TArray<FRuntimeArchiverTarSparseRegion>& SparseRegions);
+
 	/**
 	 * Write the archived data from the current position
 	 *
@@ -167,13 +908,38 @@ public:
 	 */
 	bool WriteData(const TArray64<uint8>& DataToBeArchived);
 
+	/**
+	 * Write the archived data from the current position. Can be called multiple times to write the entry data in chunks
+	 * The padding is written once all the data declared in the header has been written
+	 *
+	 * @param Data Binary data to be archived
+	 * @param Size Data size. Must not exceed the remaining entry data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteData(const void* Data, int64 Size);
+
+	/**
+	 * Abandon the entry whose data is being written, e.g. because its source failed to be read. The rest of the data declared in the header is filled with zeros
+	 * and the entry is then removed. Entries of archives split into volumes are kept with the zero-filled data instead, as the write position cannot be moved back over a volume
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool AbandonEntryData();
+
 	/**
 	 * Write null bytes represented as null character '\0'
 	 *
 	 * @param NumOfBytes Number of null bytes to write
 	 * @return Whether the operation was successful or not
 	 */
-	bool WriteNullBytes(int64 NumOfBytes) const;
+	bool WriteNullBytes(int64 NumOfBytes);
+
+	/**
+	 * Write all buffered records to the stream
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool FlushWriteBuffer();
 
 	/**
 	 * Write additional null bytes at the end to finalize the archive data
@@ -183,18 +949,329 @@ public:
 	bool Finalize();
 
 private:
+	/**
+	 * Take ownership of the opened stream, passing its data through a hashing stream if the checksums are computed
+	 *
+	 * @param InStream Opened stream
+	 */
+	void SetStream(TUniquePtr<FRuntimeArchiverBaseStream> InStream);
+
+	/**
+	 * Find the entry whose header is at the specified position
+	 *
+	 * @param HeaderOffset Position of the entry header
+	 * @return Entry index, or INDEX_NONE if there is no such entry
+	 */
+	int32 FindEntryIndexByHeaderOffset(int64 HeaderOffset) const;
+
+	/**
+	 * Add the entry record to the entry index
+	 *
+	 * @param Record Entry record to add
+	 */
+	void AddEntryRecord(FRuntimeArchiverTarEntryRecord&& Record);
+
+	/**
+	 * Remove the entry record from the entry index
+	 *
+	 * @param Index Entry index
+	 */
+	void RemoveEntryRecord(int32 Index);
+
+	/**
+	 * Drop the hard link and the content hash of the entry record from the lookup maps, as its content is removed or replaced
+	 *
+	 * @param Record Entry record
+	 */
+	void ForgetEntryContent(FRuntimeArchiverTarEntryRecord& Record);
+
+	/**
+	 * Update the lookup maps after the entry record was moved to another position in the archive
+	 *
+	 * @param Record Moved entry record
+	 * @param OldHeaderOffset Position of the entry header before the move
+	 */
+	void UpdateMovedEntryRecord(const FRuntimeArchiverTarEntryRecord& Record, int64 OldHeaderOffset);
+
+	/**
+	 * Delete the sidecar index file once the archive is modified in place, which may keep both its size and the spans hashed into the fingerprint
+	 * A new index file is saved on finalization
+	 */
+	void InvalidateIndexFile();
+
+	/**
+	 * Vacate the region so that readers skip it. Only the vacated headers and the delimiters of their data are written
+	 * Large regions are vacated by a chain of headers, each covering at most MaxVacatedRecordSize bytes
+	 *
+	 * @param Offset Position of the region in the archive
+	 * @param Size Region size. Must be a non-zero multiple of the tar block size
+	 * @return Whether the operation was successful or not
+	 */
+	bool VacateRegion(int64 Offset, int64 Size);
+
+	/**
+	 * Undo the reservation of an entry whose data failed to be written, so that the archive does not contain the header without its data
+	 * The entry is removed and its region vacated. Archives split into volumes, or those whose region cannot be vacated, are marked as damaged instead
+	 *
+	 * @param DataOffset Position of the reserved data region
+	 * @param Size Data size of the entry
+	 */
+	void AbandonReservedEntry(int64 DataOffset, int64 Size);
+
+	/**
+	 * Append raw bytes to the write buffer, flushing full blocks to the stream as needed
+	 *
+	 * @param Data Data to write. Null bytes are written if nullptr
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool BufferedWrite(const void* Data, int64 Size);
+
+	/**
+	 * Move the stream past the sparse extension headers that follow the specified header, if any
+	 *
+	 * @param Header Header that was read last
+	 * @return Whether the operation was successful or not
+	 */
+	bool SkipSparseExtensionHeaders(const FTarHeader& Header);
+
+	/**
+	 * Read raw archive data at the specified position using the positional read of the stream, keeping the current read/write position
+	 *
+	 * @param Offset Position of the data in the archive
+	 * @param Data Buffer to read the data into
+	 * @param Size Number of bytes to read
+	 * @return Whether the operation was successful or not
+	 */
+	bool ReadRawData(int64 Offset, void* Data, int64 Size);
+
+	/**
+	 * Write raw archive data at the specified position using the positional write of the stream, keeping the current write position
+	 *
+	 * @param Offset Position of the data in the archive
+	 * @param Data Data to write
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteRawData(int64 Offset, const void* Data, int64 Size);
+
+	/**
+	 * Copy raw archive data towards the start of the archive. The source and destination ranges may overlap
+	 *
+	 * @param SourceOffset Position of the data to copy
+	 * @param DestinationOffset Position to copy the data to. Must not exceed SourceOffset
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool MoveRawData(int64 SourceOffset, int64 DestinationOffset, int64 Size);
+
+	/**
+	 * Write the headers reserved at the start of the volumes: a continuation header if an entry is cut by the start of the volume, a volume header otherwise
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteVolumeHeaders();
+
+	/**
+	 * Get the position right after the entry with the specified index
+	 */
+	int64 GetEntryEnd(int32 Index) const;
+
+	/**
+	 * Get the position right after the last indexed entry, where the end-of-archive marker starts
+	 */
+	int64 GetEndOfEntriesOffset() const;
+
+	/**
+	 * Get the path of the sidecar index file of the archive opened from a file
+	 */
+	FString GetIndexFilePath() const;
+
+	/**
+	 * Compute the archive fingerprint stored in the index file, used to detect that the index file does not match the archive
+	 * Covers the archive size, its modification time and the data at its head and tail
+	 *
+	 * @param ArchiveSize Archive size
+	 * @param Fingerprint Computed fingerprint
+	 * @return Whether the operation was successful or not
+	 */
+	bool ComputeFingerprint(int64 ArchiveSize, uint64& Fingerprint);
+
+	/**
+	 * Save the entry index to the sidecar index file
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool SaveIndexFile();
+
+	/**
+	 * Load the entry index from the sidecar index file
+	 *
+	 * @return Whether the index file exists, matches the archive and was loaded
+	 */
+	bool LoadIndexFile();
+
+	/**
+	 * Get the logical write position, taking into account the buffered data
+	 */
+	int64 GetWritePosition() const;
+
 	/** Used stream */
 	TUniquePtr<FRuntimeArchiverBaseStream> Stream;
 
+	/** Path of the archive opened from a file */
+	FString ArchiveFilePath;
+
+	/** Data of the archive opened in memory or memory-mapped for reading. Owned by the stream */
+	TArrayView64<const uint8> ArchiveMemory;
+
+	/** Stream of the archive split into volumes. Owned by the stream */
+	FRuntimeArchiverVolumeStream* VolumeStream;
+
+	/** Stream of the archive created in memory. Owned by the stream */
+	FRuntimeArchiverSegmentedMemoryStream* SegmentedMemoryStream;
+
+	/** Stream computing the archive checksum, wrapping the stream of the archive. Null if the checksums are not computed */
+	FRuntimeArchiverHashingStream* HashingStream;
+
 	/** Remaining read or write data size */
 	int64 RemainingDataSize;
 
+	/** Header of the entry begun with BeginStreamedEntry, patched with the final size once the entry is ended. Null if no entry is being streamed */
+	TUniquePtr<FTarHeader> StreamedEntryHeader;
+
+	/** Size of the data appended to the entry being streamed so far */
+	int64 StreamedEntrySize;
+
 	/** Last header position */
 	int64 LastHeaderPosition;
 
-	/** Cached number of headers for a small optimization */
-	int32 CachedNumOfHeaders;
+	/** Checksum of the data of the entry being read or written so far */
+	uint32 CurrentEntryChecksum;
+
+	/** Entry index. Built on open in read mode and journaled on write */
+	TArray<FRuntimeArchiverTarEntryRecord> EntryRecords;
+
+	/** Header positions of the entries mapped by entry name. Unlike the indices, the positions do not change when a preceding entry is removed */
+	TMap<FString, int64, FDefaultSetAllocator, TRuntimeArchiverTarEntryNameKeyFuncs<int64>> EntryHeaderOffsetsByName;
+
+	/** Header positions of the entries mapped by content hash. Only filled for the entries written with deduplication enabled */
+	TMap<uint64, TArray<int64>> EntryHeaderOffsetsByContentHash;
+
+	/** Number of hard links mapped by the name of the entry they point to */
+	TMap<FString, int32, FDefaultSetAllocator, TRuntimeArchiverTarEntryNameKeyFuncs<int32>> NumOfHardLinksByTargetName;
+
+	/** Whether any entry name occurs more than once, in which case removing an entry may uncover a later entry with the same name */
+	bool bHasDuplicateNames;
+
+	/** Records assembled in memory that have not been written to the stream yet */
+	TArray64<uint8> WriteBuffer;
+
+	/** Write buffer capacity. Always a multiple of the tar block size */
+	int64 WriteBufferCapacity;
+
+	/** Size of the buffer of the file stream */
+	int64 FileBufferSize;
 
 	/** Whether the tar archive was finalized or not */
 	bool bIsFinalized;
+
+	/** Whether the write position was moved back over removed entries, leaving stale data after it that is truncated on finalization */
+	bool bHasStaleTail;
+
+	/** Whether a reserved entry was left without its data, in which case the archive is damaged and is not finalized */
+	bool bHasDamagedEntry;
+
+	/** Whether the sidecar index file was deleted since the archive was modified in place */
+	bool bIsIndexFileInvalidated;
+
+	/** Whether to use the sidecar index file */
+	bool bUseIndexFile;
+
+	/** Whether to read archives in storage through a memory mapping */
+	bool bMemoryMapArchive;
+
+	/** Number of asynchronous read requests kept in flight when reading archives in storage */
+	int32 NumOfAsyncReadRequests;
+
+	/** Size of an asynchronous read request */
+	int64 AsyncReadRequestSize;
+
+	/** Whether to compute the checksums of the archive and of the entry data */
+	bool bComputeChecksums;
+
+	/** Lock held while reserving entries and while the entry records are accessed by concurrent writers or extraction tasks, e.g. to record the entry checksums. Recursive, so that the callers may hold it across several reservations */
+	mutable FCriticalSection WriteLock;
+};
+
+/**
+ * Reader that returns the data of a single tar entry in chunks. Created by URuntimeArchiverTar::OpenEntryReader
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverTarEntryReader
+{
+public:
+	/**
+	 * @param InArchiver Archiver the entry belongs to
+	 * @param InSize Entry content size
+	 * @param InSparseRegions Regions of a sparse entry that contain data. Empty for regular entries
+	 */
+	FRuntimeArchiverTarEntryReader(URuntimeArchiverTar* InArchiver, int64 InSize, TArray<FRuntimeArchiverTarSparseRegion> InSparseRegions = TArray<FRuntimeArchiverTarSparseRegion>());
+
+	/**
+	 * Read the next chunk of the entry data. The holes of sparse entries are returned as zeros
+	 *
+	 * @param Data Buffer to read the data into
+	 * @param MaxSize Buffer size
+	 * @param BytesRead Number of bytes actually read. Less than MaxSize at the end of the entry or at a boundary between a hole and data of a sparse entry
+	 * @return Whether the operation was successful or not
+	 */
+	bool Read(void* Data, int64 MaxSize, int64& BytesRead);
+
+	/**
+	 * Skip the hole of a sparse entry at the current position without producing its zeros
+	 *
+	 * @return Size of the skipped hole. 0 if the current position is not within a hole
+	 */
+	int64 SkipHole();
+
+	/**
+	 * Get the entry data size
+	 */
+	int64 GetSize() const { return Size; }
+
+	/**
+	 * Get the size of the entry data that has not been read yet
+	 */
+	int64 GetRemainingSize() const { return RemainingSize; }
+
+	/**
+	 * Check whether all the entry data has been read
+	 */
+	bool IsFinished() const { return RemainingSize == 0; }
+
+private:
+	/**
+	 * Get the size of the hole of a sparse entry at the current position
+	 *
+	 * @return Remaining size of the hole. 0 if the current position is not within a hole
+	 */
+	int64 GetHoleSize();
+
+	/** Archiver the entry belongs to */
+	TWeakObjectPtr<URuntimeArchiverTar> Archiver;
+
+	/** Encapsulator the reader was opened on. Used to detect that the archive was closed in the meantime */
+	FRuntimeArchiverTarEncapsulator* Encapsulator;
+
+	/** Entry data size */
+	int64 Size;
+
+	/** Size of the entry data that has not been read yet */
+	int64 RemainingSize;
+
+	/** Regions of a sparse entry that contain data */
+	TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+	/** Index of the first sparse region that does not end before the current position */
+	int32 SparseRegionIndex;
 };
@@ -0,0 +1,134 @@
+﻿// Georgy Treshchev 2024.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Streams/RuntimeArchiverBaseStream.h"
+#include "ArchiverTar/RuntimeArchiverTar.h"
+
+struct FTarHeader;
+struct FRuntimeArchiveEntry;
+struct FRuntimeArchiverTarSparseRegion;
+
+/**
+ * Forward-only tar scanner. Reads each header exactly once and skips the entry data by seeking, or by reading and discarding it if the stream is not seekable
+ * Only sequential reads are required, which allows listing archives coming from pipes or decompressors without materializing them
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverTarScanner
+{
+public:
+	/**
+	 * @param InStream Stream to scan, starting at its current position. Must outlive the scanner
+	 */
+	explicit FRuntimeArchiverTarScanner(FRuntimeArchiverBaseStream& InStream);
+
+	/**
+	 * Advance to the next entry, skipping the unread data of the current entry and the regions vacated by removed entries
+	 *
+	 * @param Header Header of the next entry
+	 * @return Whether the next entry was read. Returns false at the end of the archive or if an error occurred (see HasError)
+	 */
+	bool Next(FTarHeader& Header);
+
+	/**
+	 * Advance to the next entry, skipping the unread data of the current entry
+	 *
+	 * @param Entry Information about the next entry
+	 * @return Whether the next entry was read. Returns false at the end of the archive or if an error occurred (see HasError)
+	 */
+	bool Next(FRuntimeArchiveEntry& Entry);
+
+	/**
+	 * Read the data of the current entry. Can be called multiple times to read the data in chunks
+	 *
+	 * @param Data Buffer to read the data into
+	 * @param Size Number of bytes to read. Must not exceed the remaining entry data size
+	 * @return Whether the operation was successful or not
+	 */
+	bool ReadData(void* Data, int64 Size);
+
+	/**
+	 * Get the index of the current entry
+	 */
+	int32 GetEntryIndex() const { return EntryIndex; }
+
+	/**
+	 * Get the position of the current entry header in the stream
+	 */
+	int64 GetHeaderOffset() const { return HeaderOffset; }
+
+	/**
+	 * Get the position of the current entry data in the stream
+	 */
+	int64 GetDataOffset() const { return DataOffset; }
+
+	/**
+	 * Get the size of the current entry data that has not been read yet
+	 */
+	int64 GetRemainingDataSize() const { return RemainingDataSize; }
+
+	/**
+	 * Get the content size of the current entry. Differs from the data size only for sparse entries, where it also includes the holes
+	 */
+	int64 GetRealSize() const { return RealSize; }
+
+	/**
+	 * Get the regions of the current sparse entry stored one after another in the entry data. Empty for regular entries
+	 */
+	const TArray<FRuntimeArchiverTarSparseRegion>& GetSparseRegions() const { return SparseRegions; }
+
+	/**
+	 * Check whether the scanning stopped because of an error rather than because the end of the archive was reached
+	 */
+	bool HasError() const { return bHasError; }
+
+private:
+	/**
+	 * Move the stream forward, seeking if possible and reading otherwise
+	 *
+	 * @param Size Number of bytes to skip
+	 * @return Whether the operation was successful or not
+	 */
+	bool Skip(int64 Size);
+
+	/**
+	 * Read the sparse map of the current entry, including the extension headers that follow the header
+	 *
+	 * @param Header Header of the current entry
+	 * @return Whether the sparse map was read and is consistent with the entry sizes
+	 */
+	bool ReadSparseMap(const FTarHeader& Header);
+
+	/** Scanned stream */
+	FRuntimeArchiverBaseStream& Stream;
+
+	/** Buffer used to discard data of non-seekable streams */
+	TArray64<uint8> DiscardBuffer;
+
+	/** Index of the current entry */
+	int32 EntryIndex;
+
+	/** Position of the current entry header */
+	int64 HeaderOffset;
+
+	/** Position of the current entry data */
+	int64 DataOffset;
+
+	/** Size of the current entry data that has not been read yet */
+	int64 RemainingDataSize;
+
+	/** Size of the padding following the current entry data */
+	int64 PaddingSize;
+
+	/** Content size of the current entry */
+	int64 RealSize;
+
+	/** Regions of the current sparse entry */
+	TArray<FRuntimeArchiverTarSparseRegion> SparseRegions;
+
+	/** Whether the end of the archive has been reached */
+	bool bIsFinished;
+
+	/** Whether an error has occurred */
+	bool bHasError;
+};
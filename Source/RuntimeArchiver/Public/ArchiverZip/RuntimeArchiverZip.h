@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "RuntimeArchiverBase.h"
+#include "Streams/RuntimeArchiverBaseStream.h"
 #include "RuntimeArchiverZip.generated.h"
 
 /**
@@ -18,6 +19,13 @@ public:
 	/** Default constructor */
 	URuntimeArchiverZip();
 
+	/**
+	 * Whether to read the archive file through a memory mapping instead of the file functions of miniz. Falls back to the buffered file if the file cannot be mapped
+	 * Takes effect when the archive is opened in storage to read
+	 */
+	UPROPERTY(BlueprintReadWrite, Category = "Runtime Archiver|Zip")
+	bool bMemoryMapArchive;
+
 	//~ Begin URuntimeArchiverBase Interface
 	virtual bool CreateArchiveInStorage(FString ArchivePath) override;
 	virtual bool CreateArchiveInMemory(int32 InitialAllocationSize = 0) override;
@@ -61,4 +69,7 @@ private:
 
 	/** Miniz archiver */
 	void* MinizArchiver;
+
+	/** Stream the archive opened from storage is read through by miniz. Only used if the archive is memory-mapped */
+	TUniquePtr<FRuntimeArchiverBaseStream> ArchiveStream;
 };
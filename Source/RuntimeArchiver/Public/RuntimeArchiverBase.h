@@ -219,7 +219,7 @@ public:
 	 * @param bForceOverwrite Whether to force a file to be overwritten if it exists or not
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Runtime Archiver|Extract")
-	void ExtractEntriesToStorage(const FRuntimeArchiverAsyncOperationResult& OnResult, const FRuntimeArchiverAsyncOperationProgress& OnProgress, TArray<FRuntimeArchiveEntry> EntryInfo, FString DirectoryPath, bool bForceOverwrite = true);
+	virtual void ExtractEntriesToStorage(const FRuntimeArchiverAsyncOperationResult& OnResult, const FRuntimeArchiverAsyncOperationProgress& OnProgress, TArray<FRuntimeArchiveEntry> EntryInfo, FString DirectoryPath, bool bForceOverwrite = true);
 
 	/**
 	 * Extract entries to storage. Must be used for directories only
@@ -268,6 +268,27 @@ public:
 	virtual void Reset();
 
 protected:
+	/**
+	 * Add the file entry from the specified file. Called by AddEntryFromStorage after the file path has been validated
+	 * By default, the file is fully loaded into memory and then added using AddEntryFromMemory. Archivers that can write entries in chunks should override it
+	 *
+	 * @param EntryName Entry name. In other words, the name of the file in the archive
+	 * @param FilePath Normalized path to the file to be archived
+	 * @param CompressionLevel Compression level. The higher the level, the more compression
+	 * @return Whether the operation was successful or not
+	 */
+	virtual bool AddFileEntryFromStorage(const FString& EntryName, const FString& FilePath, ERuntimeArchiverCompressionLevel CompressionLevel);
+
+	/**
+	 * Extract the file entry to the specified file. Called by ExtractEntryToStorage after the file path has been validated
+	 * By default, the entry is fully extracted into memory and then saved to the file. Archivers that can read entries in chunks should override it
+	 *
+	 * @param EntryInfo Information about the entry
+	 * @param FilePath Normalized path to the file to extract to
+	 * @return Whether the operation was successful or not
+	 */
+	virtual bool ExtractFileEntryToStorage(const FRuntimeArchiveEntry& EntryInfo, const FString& FilePath);
+
 	/**
 	 * Report an error in the archiver
 	 *
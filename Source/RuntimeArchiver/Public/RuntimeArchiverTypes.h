@@ -15,7 +15,8 @@ enum class ERuntimeArchiverErrorCode : uint8
 	AddError,
 	CloseError,
 	GetError,
-	InvalidArgument
+	InvalidArgument,
+	RemoveError
 };
 
 /** Archive entry compression level. The higher the level, the more compression */
@@ -92,6 +93,10 @@ struct FRuntimeArchiveEntry
 	UPROPERTY(BlueprintReadOnly, Category = "Runtime Archiver")
 	FDateTime CreationTime;
 
+	/** CRC32 checksum of the entry data, or -1 if it is not known. For tar archives, computed while the data passes through the archiver, and only covering the stored regions of sparse entries */
+	UPROPERTY(BlueprintReadOnly, Category = "Runtime Archiver")
+	int64 Checksum;
+
 	/** Default constructor */
 	FRuntimeArchiveEntry()
 		: Index(0)
@@ -100,6 +105,7 @@ struct FRuntimeArchiveEntry
 	  , UncompressedSize(0)
 	  , CompressedSize(0)
 	  , CreationTime(FDateTime())
+	  , Checksum(-1)
 	{
 	}
 
@@ -111,6 +117,7 @@ struct FRuntimeArchiveEntry
 	  , UncompressedSize(0)
 	  , CompressedSize(0)
 	  , CreationTime(FDateTime())
+	  , Checksum(-1)
 	{
 	}
 };
@@ -0,0 +1,110 @@
+﻿// Georgy Treshchev 2024.
+
+#pragma once
+
+#include "RuntimeArchiverBaseStream.h"
+
+class IAsyncReadFileHandle;
+class IAsyncReadRequest;
+
+/**
+ * Asynchronous file tar stream. Keeps several read requests of the archive file in flight ahead of the position through the engine's async file API,
+ * so that sequential reading is limited by the device bandwidth rather than by the latency of each read. Seeking outside of the requested data restarts the requests
+ * Positional reads issue their own requests and do not use the requests kept in flight
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverAsyncFileStream : public FRuntimeArchiverBaseStream
+{
+public:
+	/** Default number of read requests kept in flight */
+	static constexpr int32 DefaultNumOfRequests = 4;
+
+	/** Default size of a read request, in bytes */
+	static constexpr int64 DefaultRequestSize = 1024 * 1024;
+
+	/** It should be impossible to create this object by the default constructor */
+	FRuntimeArchiverAsyncFileStream() = delete;
+
+	/**
+	 * Open a tar archive file stream for reading
+	 *
+	 * @param ArchivePath Path to open an archive
+	 * @param NumOfRequests Number of read requests kept in flight
+	 * @param RequestSize Size of a read request, in bytes
+	 */
+	explicit FRuntimeArchiverAsyncFileStream(const FString& ArchivePath, int32 NumOfRequests = DefaultNumOfRequests, int64 RequestSize = DefaultRequestSize);
+
+	virtual ~FRuntimeArchiverAsyncFileStream() override;
+
+	//~ Begin FRuntimeArchiverBaseStream Interface
+	virtual bool IsValid() const override;
+	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
+	virtual bool Seek(int64 NewPosition) override;
+	virtual int64 Size() override;
+	//~ End FRuntimeArchiverBaseStream Interface
+
+private:
+	/**
+	 * Read request of a range of the file, completed or still in flight
+	 */
+	struct FReadSlot
+	{
+		/** Request in flight or completed. Nullptr if the slot is not used */
+		IAsyncReadRequest* Request = nullptr;
+
+		/** File position of the requested range */
+		int64 Offset = 0;
+
+		/** Size of the requested range */
+		int64 Size = 0;
+
+		/** Whether the request has been waited for */
+		bool bCompleted = false;
+
+		/** Memory the request reads into */
+		TArray64<uint8> Buffer;
+	};
+
+	/**
+	 * Issue a read request of the range following the requested data into the slot
+	 *
+	 * @param Slot Unused slot to issue the request into
+	 */
+	void IssueRequest(FReadSlot& Slot);
+
+	/**
+	 * Wait for the request of the slot to complete, cancelling it first if requested, and release it
+	 *
+	 * @param Slot Slot to release
+	 * @param bCancel Whether to cancel the request instead of waiting for its data
+	 */
+	void ReleaseRequest(FReadSlot& Slot, bool bCancel);
+
+	/**
+	 * Release all requests and issue new ones starting at the specified position
+	 *
+	 * @param NewOffset File position to request the data from
+	 */
+	void RestartRequests(int64 NewOffset);
+
+	/** The async file handle used to read */
+	IAsyncReadFileHandle* FileHandle;
+
+	/** Read request slots used as a ring. The requests are issued in ascending file order starting at FirstSlotIndex */
+	TArray<FReadSlot> Slots;
+
+	/** Index of the slot with the lowest requested range */
+	int32 FirstSlotIndex;
+
+	/** Number of slots with requests issued */
+	int32 NumOfUsedSlots;
+
+	/** Size of a read request */
+	int64 RequestSize;
+
+	/** File position following the last requested range */
+	int64 NextRequestOffset;
+
+	/** File size */
+	int64 FileSize;
+};
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+
 /**
  * Base tar archive stream. Do not create it directly
  */
@@ -44,6 +47,11 @@ public:
 	 */
 	int64 Tell() const { return Position; }
 
+	/**
+	 * Check whether the stream supports changing the position using Seek. Non-seekable streams, such as decompressor outputs, can only be read sequentially
+	 */
+	virtual bool IsSeekable() const { return true; }
+
 	/**
 	 * Seek archived data at a specified position. In other words, change the current write or read position
 	 *
@@ -81,6 +89,67 @@ public:
 		return false;
 	}
 
+	/**
+	 * Read archived data at the specified position without changing the current position
+	 * Can be called from several threads at the same time, but not at the same time as the operations using the current position
+	 * By default, the calls are serialized and the position is moved and restored. Streams that can read at arbitrary positions override it to read concurrently
+	 *
+	 * @param Offset Position to read the data from
+	 * @param Data In-memory data pointer to fill
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size)
+	{
+		FScopeLock Lock(&PositionalLock);
+
+		const int64 PreviousPosition = Position;
+		const bool bSuccess = Seek(Offset) && Read(Data, Size);
+
+		return Seek(PreviousPosition) && bSuccess;
+	}
+
+	/**
+	 * Write archived data at the specified position without changing the current position
+	 * Can be called from several threads at the same time, but not at the same time as the operations using the current position
+	 * By default, the calls are serialized and the position is moved and restored. Streams that can write at arbitrary positions override it to write concurrently
+	 *
+	 * @param Offset Position to write the data at
+	 * @param Data In-memory data pointer to retrieve
+	 * @param Size Data size
+	 * @return Whether the operation was successful or not
+	 */
+	virtual bool WriteAt(int64 Offset, const void* Data, int64 Size)
+	{
+		FScopeLock Lock(&PositionalLock);
+
+		const int64 PreviousPosition = Position;
+		const bool bSuccess = Seek(Offset) && Write(Data, Size);
+
+		return Seek(PreviousPosition) && bSuccess;
+	}
+
+	/**
+	 * Truncate the stream to the specified size, discarding the data after it. Not all streams support truncation
+	 *
+	 * @param NewSize Size to truncate to. Must not exceed the current size
+	 * @return Whether the operation was successful or not
+	 */
+	virtual bool Truncate(int64 NewSize)
+	{
+		return false;
+	}
+
+	/**
+	 * Write the data buffered by the stream to the underlying storage
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	virtual bool Flush()
+	{
+		return true;
+	}
+
 	/**
 	 * Get the total size
 	 */
@@ -96,4 +165,7 @@ protected:
 
 	/** Whether there is write permission or not */
 	bool bWrite;
+
+	/** Lock held by the default positional reads and writes, which temporarily move the current position */
+	FCriticalSection PositionalLock;
 };
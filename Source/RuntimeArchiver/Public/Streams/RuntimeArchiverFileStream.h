@@ -3,13 +3,21 @@
 #pragma once
 
 #include "RuntimeArchiverBaseStream.h"
+#include "Templates/UniquePtr.h"
 
 /**
  * File tar stream. Manages data at the file system level
+ * Small reads and writes go through an internal buffer: reads fill it ahead of the position, writes are collected in it until they leave the buffered range, and seeks only move the position
+ * Positional reads use their own file handles, so that several threads read the file at the same time without waiting for each other
+ * Positional writes bypass the buffer and the position and only hold the file handle for the write itself, since platforms open a file for writing exclusively
+ * In write mode, both may run at the same time as the operations using the position, as long as they do not touch the same range of the file
  */
 class RUNTIMEARCHIVER_API FRuntimeArchiverFileStream : public FRuntimeArchiverBaseStream
 {
 public:
+	/** Default size of the internal buffer, in bytes */
+	static constexpr int64 DefaultBufferSize = 256 * 1024;
+
 	/** It should be impossible to create this object by the default constructor */
 	FRuntimeArchiverFileStream() = delete;
 
@@ -18,20 +26,72 @@ public:
 	 *
 	 * @param ArchivePath Path to open an archive
 	 * @param bWrite Whether to open for writing or not
+	 * @param bAppend Whether to keep the existing file contents when opening for writing. The file remains readable and seekable
+	 * @param BufferSize Size of the internal buffer, in bytes. Reads and writes of at least this size go to the file directly. 0 disables buffering
 	 */
-	explicit FRuntimeArchiverFileStream(const FString& ArchivePath, bool bWrite);
+	explicit FRuntimeArchiverFileStream(const FString& ArchivePath, bool bWrite, bool bAppend = false, int64 BufferSize = DefaultBufferSize);
 
 	virtual ~FRuntimeArchiverFileStream() override;
 
 	//~ Begin FRuntimeArchiverBaseStream Interface
 	virtual bool IsValid() const override;
 	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
 	virtual bool Write(const void* Data, int64 Size) override;
+	virtual bool WriteAt(int64 Offset, const void* Data, int64 Size) override;
 	virtual bool Seek(int64 NewPosition) override;
+	virtual bool Truncate(int64 NewSize) override;
+	virtual bool Flush() override;
 	virtual int64 Size() override;
 	//~ End FRuntimeArchiverBaseStream Interface
 
 private:
+	/**
+	 * Write the buffered data that has not reached the file yet
+	 *
+	 * @return Whether the operation was successful or not
+	 */
+	bool FlushBuffer();
+
+	/**
+	 * Check whether the buffer holds any data of the specified range of the file
+	 *
+	 * @param Offset Start of the range
+	 * @param Size Range size
+	 * @return Whether the range overlaps the buffered data or not
+	 */
+	bool IsRangeBuffered(int64 Offset, int64 Size) const;
+
+	/** Path to the file */
+	FString ArchivePath;
+
 	/** The file handle used to read or write */
 	IFileHandle* FileHandle;
+
+	/** File handles used by positional reads that are not in use at the moment. A new one is opened if all are in use */
+	TArray<TUniquePtr<IFileHandle>> PositionalHandles;
+
+	/** Lock held while the positional read handles are taken or returned */
+	FCriticalSection PositionalHandlesLock;
+
+	/** Lock guarding the buffer, the file size and the file handle, which the positional operations use while the operations using the position run on another thread */
+	FCriticalSection FileLock;
+
+	/** File data starting at BufferOffset, either read ahead or written but possibly not flushed yet */
+	TArray64<uint8> Buffer;
+
+	/** Maximum size of the buffered data */
+	int64 BufferCapacity;
+
+	/** File position of the buffered data */
+	int64 BufferOffset;
+
+	/** Start of the buffered data that has not been written to the file yet, relative to BufferOffset */
+	int64 DirtyStart;
+
+	/** End of the buffered data that has not been written to the file yet, relative to BufferOffset. Equals DirtyStart if there is no such data */
+	int64 DirtyEnd;
+
+	/** File size, including the buffered data that has not been written to the file yet */
+	int64 FileSize;
 };
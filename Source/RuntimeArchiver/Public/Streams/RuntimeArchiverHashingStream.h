@@ -0,0 +1,80 @@
+﻿// Georgy Treshchev 2024.
+
+#pragma once
+
+#include "RuntimeArchiverBaseStream.h"
+
+/**
+ * Hashing tar stream. Passes the data through to another stream and computes the CRC32 checksum of the archive as the data is written or read, so that no separate pass over the archive is needed
+ * The checksum covers the data from the start of the archive for as long as it is written or read in order. Data skipped by seeking ahead is not hashed, and overwriting the hashed data makes the whole stream be hashed again once the checksum is requested
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverHashingStream : public FRuntimeArchiverBaseStream
+{
+public:
+	/** It should be impossible to create this object by the default constructor */
+	FRuntimeArchiverHashingStream() = delete;
+
+	/**
+	 * @param InInnerStream Stream to pass the data to
+	 */
+	explicit FRuntimeArchiverHashingStream(TUniquePtr<FRuntimeArchiverBaseStream> InInnerStream);
+
+	virtual ~FRuntimeArchiverHashingStream() override = default;
+
+	//~ Begin FRuntimeArchiverBaseStream Interface
+	virtual bool IsValid() const override;
+	virtual bool IsSeekable() const override;
+	virtual bool Seek(int64 NewPosition) override;
+	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool Write(const void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
+	virtual bool WriteAt(int64 Offset, const void* Data, int64 Size) override;
+	virtual bool Truncate(int64 NewSize) override;
+	virtual bool Flush() override;
+	virtual int64 Size() override;
+	//~ End FRuntimeArchiverBaseStream Interface
+
+	/**
+	 * Get the checksum of the whole archive. Data that has not passed through the stream yet is read from the inner stream, as is the whole stream if the hashed data has been overwritten
+	 *
+	 * @param OutChecksum Filled CRC32 checksum
+	 * @return Whether the operation was successful or not
+	 */
+	bool GetChecksum(uint32& OutChecksum);
+
+	/**
+	 * Update the CRC32 checksum with the data. Unlike FCrc::MemCrc32, accepts data of any size
+	 *
+	 * @param InChecksum Checksum of the preceding data, or 0 for the first data
+	 * @param Data Data to hash
+	 * @param Size Data size
+	 * @return Checksum of the preceding data followed by this data
+	 */
+	static uint32 UpdateChecksum(uint32 InChecksum, const void* Data, int64 Size);
+
+private:
+	/**
+	 * Account for the data that has passed through the stream at the specified position
+	 *
+	 * @param Offset Position of the data
+	 * @param Data Data that was read or written
+	 * @param Size Data size
+	 * @param bIsWritten Whether the data was written, replacing what was there before
+	 */
+	void HashData(int64 Offset, const void* Data, int64 Size, bool bIsWritten);
+
+	/** Stream the data is passed to */
+	TUniquePtr<FRuntimeArchiverBaseStream> InnerStream;
+
+	/** Checksum of the data from the start of the archive up to HashedSize */
+	uint32 Checksum;
+
+	/** Size of the data covered by the checksum */
+	int64 HashedSize;
+
+	/** Whether the checksum still matches the data, which is no longer the case once the hashed data is overwritten */
+	bool bIsChecksumValid;
+
+	/** Lock guarding the checksum, since positional reads can be performed from several threads */
+	FCriticalSection ChecksumLock;
+};
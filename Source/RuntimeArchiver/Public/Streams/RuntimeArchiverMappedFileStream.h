@@ -0,0 +1,56 @@
+﻿// Georgy Treshchev 2024.
+
+#pragma once
+
+#include "RuntimeArchiverBaseStream.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+class FRuntimeArchiverFileStream;
+
+/**
+ * Memory-mapped file tar stream. Reads the archive file through a read-only mapping, so that reads are served from the page cache without system calls
+ * Falls back to the file stream if the platform or the file does not support mapping
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverMappedFileStream : public FRuntimeArchiverBaseStream
+{
+public:
+	/** It should be impossible to create this object by the default constructor */
+	FRuntimeArchiverMappedFileStream() = delete;
+
+	/**
+	 * Open a tar archive file stream for reading
+	 *
+	 * @param ArchivePath Path to open an archive
+	 * @param FallbackBufferSize Size of the internal buffer of the file stream used if the file cannot be mapped
+	 */
+	explicit FRuntimeArchiverMappedFileStream(const FString& ArchivePath, int64 FallbackBufferSize);
+
+	virtual ~FRuntimeArchiverMappedFileStream() override;
+
+	//~ Begin FRuntimeArchiverBaseStream Interface
+	virtual bool IsValid() const override;
+	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
+	virtual bool Seek(int64 NewPosition) override;
+	virtual int64 Size() override;
+	//~ End FRuntimeArchiverBaseStream Interface
+
+	/**
+	 * Get the mapped archive data. Empty if the file is read through the fallback file stream
+	 */
+	TArrayView64<const uint8> GetMappedData() const { return MappedData; }
+
+private:
+	/** Handle of the mapped file */
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+
+	/** Region covering the whole file */
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Mapped file data */
+	TArrayView64<const uint8> MappedData;
+
+	/** File stream used if the file cannot be mapped */
+	TUniquePtr<FRuntimeArchiverFileStream> FallbackStream;
+};
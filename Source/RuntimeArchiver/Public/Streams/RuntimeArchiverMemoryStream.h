@@ -3,9 +3,12 @@
 #pragma once
 
 #include "RuntimeArchiverBaseStream.h"
+#include "Misc/ScopeRWLock.h"
 
 /**
  * Memory tar stream. Manages data at the memory level
+ * Positional reads and writes access the data directly, so that several threads read or write it at the same time without waiting for each other or moving the position
+ * In write mode, only growing the data is exclusive, since it may reallocate the data under the other operations
  */
 class RUNTIMEARCHIVER_API FRuntimeArchiverMemoryStream : public FRuntimeArchiverBaseStream
 {
@@ -16,28 +19,74 @@ public:
 	virtual ~FRuntimeArchiverMemoryStream() override = default;
 	
 	/**
-	 * Read-only constructor
+	 * Read-only constructor. The data is copied into the stream
 	 *
 	 * @param ArchiveData Binary archive data
 	 */
 	explicit FRuntimeArchiverMemoryStream(const TArray64<uint8>& ArchiveData);
 
+	/**
+	 * Read-only constructor taking ownership of the data
+	 *
+	 * @param ArchiveData Binary archive data
+	 */
+	explicit FRuntimeArchiverMemoryStream(TArray64<uint8>&& ArchiveData);
+
+	/**
+	 * Read-only constructor borrowing the data. The data is not copied and must outlive the stream
+	 *
+	 * @param ArchiveData Binary archive data
+	 */
+	explicit FRuntimeArchiverMemoryStream(TArrayView64<const uint8> ArchiveData);
+
+	/**
+	 * Read-only constructor sharing ownership of the data. The data is not copied and must not be modified while the stream exists
+	 *
+	 * @param ArchiveData Binary archive data
+	 */
+	explicit FRuntimeArchiverMemoryStream(TSharedRef<const TArray64<uint8>, ESPMode::ThreadSafe> ArchiveData);
+
 	/**
 	 * Write constructor
 	 *
-	 * @param InitialAllocationSize Estimated archive size if known. Avoids unnecessary memory allocation
+	 * @param InitialAllocationSize Estimated archive size if known. Only reserves memory, the stream is empty
 	 */
 	explicit FRuntimeArchiverMemoryStream(int32 InitialAllocationSize);
 
 	//~ Begin FArchiverTarBaseStream Interface
 	virtual bool IsValid() const override;
 	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
 	virtual bool Write(const void* Data, int64 Size) override;
+	virtual bool WriteAt(int64 Offset, const void* Data, int64 Size) override;
 	virtual bool Seek(int64 NewPosition) override;
+	virtual bool Truncate(int64 NewSize) override;
 	virtual int64 Size() override;
 	//~ End FArchiverTarBaseStream Interface
 
+	/**
+	 * Get the binary archive data the stream operates on
+	 */
+	TArrayView64<const uint8> GetArchiveData() const { return bWrite ? TArrayView64<const uint8>(ArchiveData) : ArchiveView; }
+
 protected:
-	/** Binary archive data */
+	/** Binary archive data written to the stream, or read-only data owned by the stream */
 	TArray64<uint8> ArchiveData;
+
+	/** Read-only data shared with the caller */
+	TSharedPtr<const TArray64<uint8>, ESPMode::ThreadSafe> SharedArchiveData;
+
+	/** Read-only data the stream reads from. Points either to the owned, shared or borrowed data */
+	TArrayView64<const uint8> ArchiveView;
+
+	/** Lock guarding the written data. Held shared while the data is accessed and exclusively while it grows or shrinks */
+	FRWLock DataLock;
+
+private:
+	/**
+	 * Grow the written data to the specified size if it is smaller. The added data is zeroed. Must be called with DataLock held exclusively
+	 *
+	 * @param NewSize Minimum data size
+	 */
+	void GrowData(int64 NewSize);
 };
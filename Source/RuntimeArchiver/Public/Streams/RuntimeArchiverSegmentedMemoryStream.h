@@ -0,0 +1,96 @@
+﻿// Georgy Treshchev 2024.
+
+#pragma once
+
+#include "RuntimeArchiverBaseStream.h"
+#include "Templates/Function.h"
+#include "Misc/ScopeRWLock.h"
+
+/**
+ * Segmented memory tar stream. Stores the written data in a list of fixed-size segments instead of a single array,
+ * so that growing the stream never reallocates or copies the data written before. Contiguous data is only assembled on demand
+ * Positional reads and writes access the segments directly, so that several threads read or write at the same time without waiting for each other or moving the position
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverSegmentedMemoryStream : public FRuntimeArchiverBaseStream
+{
+public:
+	/** Default size of a segment, in bytes */
+	static constexpr int64 DefaultSegmentSize = 4 * 1024 * 1024;
+
+	/** It should be impossible to create this object by the default constructor */
+	FRuntimeArchiverSegmentedMemoryStream() = delete;
+
+	/**
+	 * Write constructor
+	 *
+	 * @param InitialAllocationSize Estimated archive size if known. Only reserves memory, the stream is empty
+	 * @param SegmentSize Size of a segment, in bytes
+	 */
+	explicit FRuntimeArchiverSegmentedMemoryStream(int64 InitialAllocationSize, int64 SegmentSize = DefaultSegmentSize);
+
+	virtual ~FRuntimeArchiverSegmentedMemoryStream() override = default;
+
+	//~ Begin FRuntimeArchiverBaseStream Interface
+	virtual bool IsValid() const override;
+	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
+	virtual bool Write(const void* Data, int64 Size) override;
+	virtual bool WriteAt(int64 Offset, const void* Data, int64 Size) override;
+	virtual bool Seek(int64 NewPosition) override;
+	virtual bool Truncate(int64 NewSize) override;
+	virtual int64 Size() override;
+	//~ End FRuntimeArchiverBaseStream Interface
+
+	/**
+	 * Pass the stored data to the function segment by segment, in order, without copying it
+	 *
+	 * @param Operation Function that processes a segment. Returning false stops the iteration
+	 * @return Whether all segments were processed or not
+	 */
+	bool ForEachSegment(TFunctionRef<bool(TArrayView64<const uint8> Segment)> Operation) const;
+
+	/**
+	 * Copy the stored data into a contiguous array
+	 *
+	 * @param Data Array to fill with the data
+	 */
+	void GetContiguousData(TArray64<uint8>& Data) const;
+
+private:
+	/**
+	 * Make sure that the segment with the specified index exists, adding the missing segments
+	 *
+	 * @param SegmentIndex Segment index
+	 * @return Segment with the specified index
+	 */
+	TArray64<uint8>& GetOrAddSegment(int64 SegmentIndex);
+
+	/**
+	 * Grow the stored data to the specified size if it is smaller. The added data is zeroed. Must be called with SegmentsLock held exclusively
+	 *
+	 * @param NewSize Minimum data size
+	 */
+	void GrowData(int64 NewSize);
+
+	/**
+	 * Copy the data between the stored data and the specified memory. The range must lie within the stored data
+	 *
+	 * @param Offset Position in the stored data
+	 * @param Data In-memory data pointer to fill or to retrieve
+	 * @param Size Data size
+	 * @param bIsWrite Whether to copy the memory into the stored data or the other way around
+	 */
+	void CopyData(int64 Offset, uint8* Data, int64 Size, bool bIsWrite);
+
+	/** Stored data. All segments except the last one are full */
+	TArray<TArray64<uint8>> Segments;
+
+	/** Size of a segment */
+	int64 SegmentSize;
+
+	/** Size of the stored data */
+	int64 DataSize;
+
+	/** Lock guarding the segments. Held shared while the data is accessed and exclusively while it grows or shrinks */
+	FRWLock SegmentsLock;
+};
@@ -0,0 +1,142 @@
+﻿// Georgy Treshchev 2024.
+
+#pragma once
+
+#include "RuntimeArchiverBaseStream.h"
+#include "HAL/CriticalSection.h"
+
+class IFileHandle;
+
+/**
+ * Location of a volume of a multi-volume archive within the volume stream
+ */
+struct FRuntimeArchiverVolume
+{
+	/** Path to the volume file */
+	FString Path;
+
+	/** Position in the stream where the volume data starts */
+	int64 Start;
+
+	/** Size of the volume data */
+	int64 Size;
+
+	/** Size of the volume and continuation headers that precede the volume data in the file */
+	int64 HeaderSize;
+};
+
+/**
+ * Multi-volume tar stream. Presents the volumes of a split archive as one continuous archive, leaving out the headers that start the volumes
+ * Each volume has its own lock, so that positional reads and writes of different volumes run concurrently
+ */
+class RUNTIMEARCHIVER_API FRuntimeArchiverVolumeStream : public FRuntimeArchiverBaseStream
+{
+public:
+	/** It should be impossible to create this object by the default constructor */
+	FRuntimeArchiverVolumeStream() = delete;
+
+	/**
+	 * Open the volumes of a tar archive for reading. The GNU volume and continuation headers at the start of each volume are skipped
+	 *
+	 * @param VolumePaths Paths to the volumes, in order
+	 */
+	explicit FRuntimeArchiverVolumeStream(const TArray<FString>& VolumePaths);
+
+	/**
+	 * Create a tar archive split into volumes for writing. Each volume except the first starts with a block reserved for its volume or continuation header
+	 * The volumes are created as the data reaches them and named by GetVolumePath. Volumes left over from an earlier archive with the same path are deleted
+	 *
+	 * @param ArchivePath Path to the first volume
+	 * @param MaxVolumeSize Maximum size of each volume file. Rounded down to the tar block size
+	 */
+	FRuntimeArchiverVolumeStream(const FString& ArchivePath, int64 MaxVolumeSize);
+
+	virtual ~FRuntimeArchiverVolumeStream() override;
+
+	/**
+	 * Get the path of the volume of an archive created in storage. The first volume uses the archive path as is, the others append a three-digit volume number to it
+	 *
+	 * @param ArchivePath Path to the archive
+	 * @param VolumeIndex Volume index, starting from 0
+	 * @return Path of the volume
+	 */
+	static FString GetVolumePath(const FString& ArchivePath, int32 VolumeIndex);
+
+	//~ Begin FRuntimeArchiverBaseStream Interface
+	virtual bool IsValid() const override;
+	virtual bool Read(void* Data, int64 Size) override;
+	virtual bool Write(const void* Data, int64 Size) override;
+	virtual bool ReadAt(int64 Offset, void* Data, int64 Size) override;
+	virtual bool WriteAt(int64 Offset, const void* Data, int64 Size) override;
+	virtual bool Seek(int64 NewPosition) override;
+	virtual int64 Size() override;
+	//~ End FRuntimeArchiverBaseStream Interface
+
+	/**
+	 * Write the header reserved at the start of the volume with the specified index. Only valid in write mode for the volumes other than the first one
+	 *
+	 * @param VolumeIndex Volume index
+	 * @param Header Header block to write
+	 * @return Whether the operation was successful or not
+	 */
+	bool WriteVolumeHeader(int32 VolumeIndex, const void* Header);
+
+	/**
+	 * Get the number of volumes that have been opened or created
+	 */
+	int32 GetNumOfVolumes() const;
+
+	/**
+	 * Get the locations of the volumes that have been opened or created
+	 */
+	TArray<FRuntimeArchiverVolume> GetVolumes() const;
+
+private:
+	/**
+	 * Volume along with the handle of its file
+	 */
+	struct FVolumeFile
+	{
+		/** Volume location */
+		FRuntimeArchiverVolume Volume;
+
+		/** Volume file handle */
+		TUniquePtr<IFileHandle> FileHandle;
+
+		/** Lock held while the volume file is accessed */
+		FCriticalSection Lock;
+	};
+
+	/**
+	 * Find the volume containing the specified position, creating it and the volumes before it in write mode
+	 *
+	 * @param Offset Position in the stream
+	 * @return Volume, or nullptr if there is no such volume
+	 */
+	FVolumeFile* FindVolume(int64 Offset);
+
+	/**
+	 * Split the range into the parts stored in the individual volumes and process each part with the volume file locked
+	 *
+	 * @param Offset Position of the range in the stream
+	 * @param Size Range size
+	 * @param Operation Function that processes the part of the range at the specified position in the volume file
+	 * @return Whether the operation was successful or not
+	 */
+	bool ForEachVolumePart(int64 Offset, int64 Size, TFunctionRef<bool(IFileHandle& FileHandle, int64 FileOffset, int64 PartOffset, int64 PartSize)> Operation);
+
+	/** Path to the first volume of the archive created for writing */
+	FString ArchivePath;
+
+	/** Maximum size of each volume file of the archive created for writing */
+	int64 VolumeSize;
+
+	/** Volumes opened or created so far, in order */
+	TArray<TUniquePtr<FVolumeFile>> Volumes;
+
+	/** Lock held while the volumes are looked up or created */
+	mutable FCriticalSection VolumesLock;
+
+	/** Stream size. In write mode, the end of the data written so far */
+	int64 TotalSize;
+};